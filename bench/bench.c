@@ -0,0 +1,642 @@
+#include <errno.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "buf.h"
+#include "cache.h"
+#include "coalesce.h"
+#include "compiler.h"
+#include "eval.h"
+#include "hashmap.h"
+#include "heap.h"
+#include "jit.h"
+#include "linear.h"
+#include "mem.h"
+#include "names.h"
+#include "optimize.h"
+#include "parser.h"
+#include "scanner.h"
+#include "task.h"
+#include "vdso.h"
+#include "vm.h"
+
+// Microbenchmarks for each interpreter stage. Every benchmark is run with
+// a growing op count until it takes at least MIN_NS, and one line per
+// benchmark is printed as tab-separated values:
+//
+//     name  ops  ns_per_op  ops_per_sec
+//
+// Pass benchmark names as arguments to run only those.
+
+#define MIN_NS 200000000L
+
+typedef void (*BenchFn)(long n);
+
+typedef struct {
+    const char* name;
+    BenchFn fn;
+    // Ops performed per call of fn with n == 1, for benchmarks whose
+    // unit of work is smaller than one call.
+    long (*ops)(long n);
+} Bench;
+
+static long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// A representative script, repeated to build large inputs.
+static const char* sample =
+    ".set $BUF_MAX 1024\n"
+    ".set $buf { .alloc $BUF_MAX }\n"
+    ".set $fd { open \"/tmp/bench.txt\" 578 420 }  # create\n"
+    ".while { .sub 10 $i } {\n"
+    "    .set $i { .add $i 1 }\n"
+    "    write $fd \"line\\n\" 5\n"
+    "    .if $ERRNO { write 2 'failed\\n' 7 }\n"
+    "}\n"
+    "pread64 $fd $buf $BUF_MAX 0\n"
+    "write 1 $buf $LAST\n"
+    "close $fd\n"
+    ".free $buf\n";
+
+#define SAMPLE_LINES 12
+#define SAMPLE_REPEAT 4096
+
+static char* input;
+static size_t input_len;
+static long input_tokens;
+
+static void make_input(void) {
+    size_t len = strlen(sample);
+    input_len = len * SAMPLE_REPEAT;
+    input = malloc(input_len + 1);
+    for(int i = 0; i < SAMPLE_REPEAT; i++) {
+        memcpy(input + i * len, sample, len);
+    }
+    input[input_len] = '\0';
+
+    Scanner sc = init_scanner(input, input_len);
+    while(scanner_next(&sc).type != TOK_EOF) input_tokens++;
+}
+
+static void bench_scanner(long n) {
+    long seen = 0;
+    while(seen < n) {
+        Scanner sc = init_scanner(input, input_len);
+        while(seen < n && scanner_next(&sc).type != TOK_EOF) seen++;
+    }
+}
+
+static long lines_per_parse(long n) {
+    return n * SAMPLE_LINES * SAMPLE_REPEAT;
+}
+
+static void bench_parser(long n) {
+    Symbols syms;
+    symbols_init(&syms);
+    Ast ast;
+    ast_init(&ast);
+    for(long i = 0; i < n; i++) {
+        Scanner sc = init_scanner(input, input_len);
+        BlockResult br = parse(&sc, &syms, &ast);
+        if(!br.is_ok) {
+            fprintf(stderr, "bench: parse failed: %s\n", br.as.err);
+            exit(1);
+        }
+        ast_reset(&ast);
+    }
+    ast_free(&ast);
+    symbols_free(&syms);
+}
+
+// Starting a script of SAMPLE_LINES * SAMPLE_REPEAT lines, from its
+// text and from a precompiled image of it. Both are measured per script.
+#define LOAD_SOURCE "/tmp/bench_load.sysh"
+#define LOAD_IMAGE "/tmp/bench_load.sysc"
+
+static void bench_load_parse(long n) {
+    for(long i = 0; i < n; i++) {
+        Symbols syms;
+        symbols_init(&syms);
+        Ast ast;
+        ast_init(&ast);
+        Scanner sc = init_scanner(input, input_len);
+        BlockResult br = parse(&sc, &syms, &ast);
+        if(!br.is_ok) {
+            fprintf(stderr, "bench: parse failed: %s\n", br.as.err);
+            exit(1);
+        }
+        optimize(&ast, br.as.ok, syms.len, true);
+        ast_seal(&ast);
+        ast_free(&ast);
+        symbols_free(&syms);
+    }
+}
+
+static void bench_load_cache(long n) {
+    FILE* f = fopen(LOAD_SOURCE, "w");
+    if(f == NULL || fwrite(input, 1, input_len, f) != input_len || fclose(f) != 0) {
+        fprintf(stderr, "bench: cannot write %s\n", LOAD_SOURCE);
+        exit(1);
+    }
+    Symbols syms;
+    symbols_init(&syms);
+    Ast ast;
+    ast_init(&ast);
+    Scanner sc = init_scanner(input, input_len);
+    BlockResult br = parse(&sc, &syms, &ast);
+    Block root = optimize(&ast, br.as.ok, syms.len, true);
+    Cached prog = {.root = root, .slots = syms.len};
+    if(!cache_store(LOAD_IMAGE, LOAD_SOURCE, input, input_len, &ast, prog)) {
+        fprintf(stderr, "bench: cannot write %s\n", LOAD_IMAGE);
+        exit(1);
+    }
+    ast_free(&ast);
+    symbols_free(&syms);
+    for(long i = 0; i < n; i++) {
+        ast_init(&ast);
+        if(cache_load(LOAD_IMAGE, LOAD_SOURCE, &ast, &prog) != CACHE_OK) {
+            fprintf(stderr, "bench: %s is stale\n", LOAD_IMAGE);
+            exit(1);
+        }
+        ast_free(&ast);
+    }
+    unlink(LOAD_IMAGE);
+    unlink(LOAD_SOURCE);
+}
+
+// Names looked up by the lookup benchmarks: every syscall and builtin.
+static const char* names[SYSCALL_COUNT + 16];
+static int names_len;
+
+static void make_names(void) {
+    static const char* commands[] = {
+        ".alloc", ".realloc", ".free", ".set", ".cpy", ".deref", ".if",
+        ".while", ".add", ".sub", ".mul", ".div", ".batch",
+    };
+    for(int i = 0; i < SYSCALL_COUNT; i++) {
+        if(syscall_names[i] != NULL) names[names_len++] = syscall_names[i];
+    }
+    for(size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        names[names_len++] = commands[i];
+    }
+}
+
+static volatile long sink;
+
+// The two lookup backends, generated by make bench alongside trie_get.
+long trie_switch(const char* key, size_t len);
+long trie_phf(const char* key, size_t len);
+
+// Lookups weighted towards the calls scripts actually make.
+static const char* common[16] = {
+    "read", "write", ".set", ".set", ".add", ".while", ".if", "open",
+    "close", ".alloc", ".free", "write", ".sub", "read", ".set", "mmap",
+};
+
+// Near misses that a lookup has to reject.
+static const char* misses[16] = {
+    "reed", "writ", ".sett", "opn", "closed", "mmap3", ".whilst", "x",
+    "readx", "write_", ".ad", "getpidd", "sockets", "bindd", ".iff", "exit_groups",
+};
+
+static void lookup(long (*get)(const char*, size_t), const char** keys, int mask, long n) {
+    long sum = 0;
+    for(long i = 0; i < n; i++) {
+        const char* name = keys[i & mask];
+        sum += get(name, strlen(name));
+    }
+    sink = sum;
+}
+
+static void lookup_all(long (*get)(const char*, size_t), long n) {
+    long sum = 0;
+    for(long i = 0; i < n; i++) {
+        const char* name = names[i % names_len];
+        sum += get(name, strlen(name));
+    }
+    sink = sum;
+}
+
+static void bench_switch_all(long n) { lookup_all(trie_switch, n); }
+static void bench_switch_common(long n) { lookup(trie_switch, common, 15, n); }
+static void bench_switch_miss(long n) { lookup(trie_switch, misses, 15, n); }
+static void bench_phf_all(long n) { lookup_all(trie_phf, n); }
+static void bench_phf_common(long n) { lookup(trie_phf, common, 15, n); }
+static void bench_phf_miss(long n) { lookup(trie_phf, misses, 15, n); }
+
+// The symbol table and the linear-probing table it replaced, driven the
+// same way: re-adding a working set of keys, hits on a warm table, and
+// adding and removing the same keys over and over.
+#define TABLE_BENCHES(name, Table, prefix)                              \
+    static void bench_##name##_add(long n) {                            \
+        Table map;                                                      \
+        prefix##_init(&map);                                            \
+        char key[32];                                                   \
+        for(long i = 0; i < n; i++) {                                   \
+            snprintf(key, sizeof(key), "var%ld", i & 4095);             \
+            prefix##_add(&map, key, i);                                 \
+        }                                                               \
+        prefix##_free(&map);                                            \
+    }                                                                   \
+    static void bench_##name##_get(long n) {                            \
+        Table map;                                                      \
+        prefix##_init(&map);                                            \
+        char keys[1024][16];                                            \
+        for(int i = 0; i < 1024; i++) {                                 \
+            snprintf(keys[i], sizeof(keys[i]), "var%d", i);             \
+            prefix##_add(&map, keys[i], i);                             \
+        }                                                               \
+        long sum = 0;                                                   \
+        long value;                                                     \
+        for(long i = 0; i < n; i++) {                                   \
+            if(prefix##_get(&map, keys[i & 1023], &value)) sum += value; \
+        }                                                               \
+        sink = sum;                                                     \
+        prefix##_free(&map);                                            \
+    }                                                                   \
+    static void bench_##name##_remove(long n) {                         \
+        Table map;                                                      \
+        prefix##_init(&map);                                            \
+        char key[32];                                                   \
+        for(long i = 0; i < n; i++) {                                   \
+            snprintf(key, sizeof(key), "var%ld", i & 255);              \
+            prefix##_add(&map, key, i);                                 \
+            prefix##_remove(&map, key);                                 \
+        }                                                               \
+        prefix##_free(&map);                                            \
+    }
+
+TABLE_BENCHES(hashmap, Hashmap, hashmap)
+TABLE_BENCHES(linear, Linear, linear)
+
+// Random adds, removes and lookups over a key space far larger than any
+// one group, checked against a plain array after every call. Deleted
+// slots pile up, so this also covers rehashing in place. The keys share
+// long prefixes, and with only seven bits of hash per control byte most
+// groups hold several matching tags.
+#define CHURN_KEYS 20000
+
+static void bench_hashmap_churn(long n) {
+    static long expect[CHURN_KEYS];
+    for(int i = 0; i < CHURN_KEYS; i++) expect[i] = -1;
+    Hashmap map;
+    hashmap_init(&map);
+    uint64_t state = 88172645463325252u;
+    char key[48];
+    int len = 0;
+    for(long i = 0; i < n; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int k = state % CHURN_KEYS;
+        snprintf(key, sizeof(key), "a_long_shared_symbol_prefix_%d", k);
+        long value;
+        bool ok = true;
+        switch((state >> 32) % 3) {
+        case 0:
+            ok = hashmap_add(&map, key, i) == (expect[k] < 0);
+            if(expect[k] < 0) len++;
+            expect[k] = i;
+            break;
+        case 1:
+            ok = hashmap_remove(&map, key) == (expect[k] >= 0);
+            if(expect[k] >= 0) len--;
+            expect[k] = -1;
+            break;
+        case 2:
+            ok = hashmap_get(&map, key, &value) ? value == expect[k] : expect[k] < 0;
+            break;
+        }
+        if(!ok || map.len != len) {
+            fprintf(stderr, "hashmap_churn: wrong result for %s at op %ld\n", key, i);
+            exit(1);
+        }
+    }
+    hashmap_free(&map);
+}
+
+// The buffer kernels are measured per byte of the sample input.
+static long bytes_per_scan(long n) {
+    return n * input_len;
+}
+
+static void bench_buf_count(long n) {
+    for(long i = 0; i < n; i++) sink = buf_count(input, input_len, '\n');
+}
+
+static void bench_buf_find(long n) {
+    for(long i = 0; i < n; i++) sink = buf_find(input, input_len, "$missing", 8);
+}
+
+static void bench_buf_scalar(long n) {
+    for(long i = 0; i < n; i++) {
+        long count = 0;
+        for(size_t j = 0; j < input_len; j++) count += input[j] == '\n';
+        sink = count;
+    }
+}
+
+// A script's scratch buffers: a few sizes allocated and freed in turn.
+static void bench_heap_scratch(long n) {
+    for(long i = 0; i < n; i++) {
+        void* a = heap_alloc(64 + (i & 7) * 16);
+        void* b = heap_alloc(1024);
+        heap_free(a);
+        heap_free(b);
+    }
+}
+
+static void bench_malloc_scratch(long n) {
+    for(long i = 0; i < n; i++) {
+        void* a = malloc(64 + (i & 7) * 16);
+        void* b = malloc(1024);
+        sink = (long)a ^ (long)b;
+        free(a);
+        free(b);
+    }
+}
+
+// Runs script with $N set to n, through the VM or the tree walker, with
+// hot loops compiled or not.
+static void run_script(const char* script, long n, bool tree_walk, bool jit) {
+    jit_enabled = jit;
+    Symbols syms;
+    symbols_init(&syms);
+    Ast ast;
+    ast_init(&ast);
+    Vars vars;
+    vars_init(&vars);
+    int slot = symbols_intern(&syms, "N", 1);
+    Scanner sc = init_scanner(script, strlen(script));
+    BlockResult br = parse(&sc, &syms, &ast);
+    if(!br.is_ok) {
+        fprintf(stderr, "bench: parse failed: %s\n", br.as.err);
+        exit(1);
+    }
+    ast_seal(&ast);
+    vars_resize(&vars, syms.len);
+    vars.values[slot] = n;
+    vars.set[slot] = true;
+    // As in run_program: errno left by an earlier benchmark would be
+    // reported by the first line.
+    errno = 0;
+    if(tree_walk) {
+        eval_run(&ast, br.as.ok, &vars);
+    } else {
+        Program prog;
+        program_init(&prog);
+        compile(&ast, br.as.ok, &prog);
+        vm_run(&prog, &vars);
+        program_free(&prog);
+    }
+    task_wait_all();
+    vars_free(&vars);
+    jit_flush();
+    ast_free(&ast);
+    symbols_free(&syms);
+}
+
+static const char* count_loop =
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n";
+
+static const char* cat_loop =
+    ".set $in { open \"/dev/zero\" 0 }\n"
+    ".set $out { open \"/dev/null\" 1 }\n"
+    ".set $buf { .alloc 4096 }\n"
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $read { read $in $buf 4096 }\n"
+    "    write $out $buf $read\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n"
+    ".free $buf\n"
+    "close $in\n"
+    "close $out\n";
+
+// cat_loop's work in one line: an op is still 4096 bytes.
+static const char* cat_pump =
+    ".set $in { open \"/dev/zero\" 0 }\n"
+    ".set $out { open \"/dev/null\" 1 }\n"
+    ".pump $in $out { .mul $N 4096 }\n"
+    "close $in\n"
+    "close $out\n";
+
+// The cheapest real syscall, so the time is the interpreter's entry path.
+static const char* getppid_loop =
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $i { .add $i 1 }\n"
+    "    getppid\n"
+    "}\n";
+
+static const char* clock_loop =
+    ".set $ts { .alloc 16 }\n"
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $i { .add $i 1 }\n"
+    "    clock_gettime 1 $ts\n"
+    "}\n"
+    ".free $ts\n";
+
+// One short line of output per op, as scripts that report progress do.
+static const char* write_loop =
+    ".set $out { open \"/dev/null\" 1 }\n"
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $i { .add $i 1 }\n"
+    "    write $out \"progress\\n\" 9\n"
+    "}\n"
+    "close $out\n";
+
+// Four 1ms waits per op, one after another or as tasks on the pool.
+static const char* wait_serial =
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    poll 0 0 1\n"
+    "    poll 0 0 1\n"
+    "    poll 0 0 1\n"
+    "    poll 0 0 1\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n";
+
+static const char* wait_spawn =
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $a { .spawn { poll 0 0 1 } }\n"
+    "    .set $b { .spawn { poll 0 0 1 } }\n"
+    "    .set $c { .spawn { poll 0 0 1 } }\n"
+    "    .set $d { .spawn { poll 0 0 1 } }\n"
+    "    .join $a\n"
+    "    .join $b\n"
+    "    .join $c\n"
+    "    .join $d\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n";
+
+// Fills a timespec per op: the old way, from literals, and with .pack,
+// which can also store computed values.
+static const char* timespec_cpy =
+    ".set $ts { .alloc 16 }\n"
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .cpy $ts \"\\0\\0\\0\\0\\0\\0\\0\\0\" 8\n"
+    "    .cpy { .add $ts 8 } \"\\0\\0\\0\\0\\0\\0\\0\\0\" 8\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n"
+    ".free $ts\n";
+
+static const char* timespec_pack =
+    ".set $ts { .alloc 16 }\n"
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .pack $ts \"qq\" 0 $i\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n"
+    ".free $ts\n";
+
+static void bench_timespec_cpy(long n) { run_script(timespec_cpy, n, false, false); }
+static void bench_timespec_pack(long n) { run_script(timespec_pack, n, false, false); }
+
+// Starts and reaps a process that exits at once, so the time is the
+// cost of launching it.
+static const char* launch_loop =
+    ".set $i 0\n"
+    ".while { .sub $N $i } {\n"
+    "    .set $pid { .pspawn \"/bin/true\" \"true\" 0 }\n"
+    "    wait4 $pid 0 0 0\n"
+    "    .set $i { .add $i 1 }\n"
+    "}\n";
+
+static void bench_launch_c(long n) {
+    extern char** environ;
+    char* argv[] = {"true", NULL};
+    for(long i = 0; i < n; i++) {
+        pid_t pid;
+        if(posix_spawn(&pid, "/bin/true", NULL, NULL, argv, environ) == 0) waitpid(pid, NULL, 0);
+    }
+}
+
+static void bench_launch_vm(long n) { run_script(launch_loop, n, false, false); }
+
+static void bench_getppid_vm(long n) { run_script(getppid_loop, n, false, false); }
+static void bench_getppid_tree(long n) { run_script(getppid_loop, n, true, false); }
+static void bench_getppid_jit(long n) { run_script(getppid_loop, n, false, true); }
+static void bench_clock_vdso(long n) { run_script(clock_loop, n, false, false); }
+
+static void bench_clock_syscall(long n) {
+    VdsoFn saved[SYSCALL_COUNT];
+    memcpy(saved, vdso_table, sizeof(saved));
+    memset(vdso_table, 0, sizeof(vdso_table));
+    run_script(clock_loop, n, false, false);
+    memcpy(vdso_table, saved, sizeof(saved));
+}
+
+static void bench_write_vm(long n) { run_script(write_loop, n, false, false); }
+
+static void bench_write_coalesced(long n) {
+    coalesce_enabled = true;
+    run_script(write_loop, n, false, false);
+    coalesce_flush();
+    coalesce_enabled = false;
+}
+
+static void bench_count_vm(long n) { run_script(count_loop, n, false, false); }
+static void bench_count_tree(long n) { run_script(count_loop, n, true, false); }
+static void bench_count_jit(long n) { run_script(count_loop, n, false, true); }
+static void bench_cat_vm(long n) { run_script(cat_loop, n, false, false); }
+static void bench_cat_tree(long n) { run_script(cat_loop, n, true, false); }
+static void bench_cat_jit(long n) { run_script(cat_loop, n, false, true); }
+static void bench_cat_pump(long n) { run_script(cat_pump, n, false, false); }
+static void bench_wait_serial(long n) { run_script(wait_serial, n, false, false); }
+static void bench_wait_spawn(long n) { run_script(wait_spawn, n, false, false); }
+
+static const Bench benches[] = {
+    {"scanner_next",    bench_scanner,        NULL},
+    {"parse_line",      bench_parser,         lines_per_parse},
+    {"load_parse",      bench_load_parse,     NULL},
+    {"load_cache",      bench_load_cache,     NULL},
+    {"switch_all",      bench_switch_all,     NULL},
+    {"switch_common",   bench_switch_common,  NULL},
+    {"switch_miss",     bench_switch_miss,    NULL},
+    {"phf_all",         bench_phf_all,        NULL},
+    {"phf_common",      bench_phf_common,     NULL},
+    {"phf_miss",        bench_phf_miss,       NULL},
+    {"hashmap_add",     bench_hashmap_add,    NULL},
+    {"hashmap_get",     bench_hashmap_get,    NULL},
+    {"hashmap_remove",  bench_hashmap_remove, NULL},
+    {"hashmap_churn",   bench_hashmap_churn,  NULL},
+    {"linear_add",      bench_linear_add,     NULL},
+    {"linear_get",      bench_linear_get,     NULL},
+    {"linear_remove",   bench_linear_remove,  NULL},
+    {"buf_count",       bench_buf_count,      bytes_per_scan},
+    {"buf_find",        bench_buf_find,       bytes_per_scan},
+    {"buf_scalar",      bench_buf_scalar,      bytes_per_scan},
+    {"heap_scratch",    bench_heap_scratch,   NULL},
+    {"malloc_scratch",  bench_malloc_scratch, NULL},
+    {"eval_count_vm",   bench_count_vm,       NULL},
+    {"eval_count_tree", bench_count_tree,     NULL},
+    {"eval_count_jit",  bench_count_jit,      NULL},
+    {"eval_cat_vm",     bench_cat_vm,         NULL},
+    {"eval_cat_tree",   bench_cat_tree,       NULL},
+    {"eval_cat_jit",    bench_cat_jit,        NULL},
+    {"eval_cat_pump",   bench_cat_pump,       NULL},
+    {"eval_getppid_vm", bench_getppid_vm,     NULL},
+    {"eval_getppid_tree", bench_getppid_tree, NULL},
+    {"eval_getppid_jit", bench_getppid_jit,   NULL},
+    {"eval_clock_vdso", bench_clock_vdso,     NULL},
+    {"eval_clock_syscall", bench_clock_syscall, NULL},
+    {"eval_write_vm",   bench_write_vm,       NULL},
+    {"eval_write_coalesced", bench_write_coalesced, NULL},
+    {"eval_wait_serial", bench_wait_serial,   NULL},
+    {"eval_wait_spawn", bench_wait_spawn,     NULL},
+    {"eval_launch_vm",  bench_launch_vm,      NULL},
+    {"eval_timespec_cpy", bench_timespec_cpy, NULL},
+    {"eval_timespec_pack", bench_timespec_pack, NULL},
+    {"launch_c",        bench_launch_c,       NULL},
+};
+
+static bool selected(int argc, const char** argv, const char* name) {
+    if(argc < 2) return true;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], name) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, const char** argv) {
+    make_input();
+    make_names();
+    vdso_init();
+    buf_init();
+    printf("name\tops\tns_per_op\tops_per_sec\n");
+    for(size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        const Bench* b = &benches[i];
+        if(!selected(argc, argv, b->name)) continue;
+        long n = 1;
+        long elapsed;
+        while(true) {
+            long start = now_ns();
+            b->fn(n);
+            elapsed = now_ns() - start;
+            if(elapsed >= MIN_NS) break;
+            n *= (elapsed < MIN_NS / 16) ? 16 : 2;
+        }
+        long ops = b->ops ? b->ops(n) : n;
+        double ns = (double)elapsed / ops;
+        printf("%s\t%ld\t%.2f\t%.0f\n", b->name, ops, ns, 1e9 / ns);
+        fflush(stdout);
+    }
+    free(input);
+    return 0;
+}
@@ -0,0 +1,95 @@
+// The linear-probing table the symbol index used before the Swiss table,
+// kept so make bench can compare the two.
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "linear.h"
+
+static uint32_t hash_string(const char* key) {
+    uint32_t hash = 2166136261u;
+    while(*key != '\0') {
+        hash ^= (uint8_t)(*key);
+        hash *= 16777619;
+        key++;
+    }
+    return hash;
+}
+
+void linear_init(Linear* map) {
+    map->len = 0;
+    map->capacity = 0;
+    map->entries = NULL;
+}
+
+void linear_free(Linear* map) {
+    for(int i = 0; i < map->capacity; i++) free((char*)map->entries[i].key);
+    free(map->entries);
+    linear_init(map);
+}
+
+static LinearEntry* linear_find(LinearEntry* entries, int capacity, const char* key) {
+    uint32_t index = hash_string(key) % capacity;
+    LinearEntry* tombstone = NULL;
+    while(true) {
+        LinearEntry* entry = &entries[index];
+        if(entry->key == NULL) {
+            if(entry->value == 1) {
+                if(tombstone == NULL) tombstone = entry;
+            } else {
+                return (tombstone == NULL) ? entry : tombstone;
+            }
+        } else if(strcmp(entry->key, key) == 0) {
+            return entry;
+        }
+        index = (index + 1) % capacity;
+    }
+}
+
+static void linear_grow(Linear* map, int capacity) {
+    LinearEntry* entries = calloc(capacity, sizeof(LinearEntry));
+    map->len = 0;
+    for(int i = 0; i < map->capacity; i++) {
+        LinearEntry* entry = &map->entries[i];
+        if(entry->key == NULL) continue;
+        LinearEntry* dest = linear_find(entries, capacity, entry->key);
+        *dest = *entry;
+        map->len++;
+    }
+    free(map->entries);
+    map->entries = entries;
+    map->capacity = capacity;
+}
+
+bool linear_get(Linear* map, const char* key, long* value) {
+    if(map->len == 0) return false;
+    LinearEntry* e = linear_find(map->entries, map->capacity, key);
+    if(e->key == NULL) return false;
+    *value = e->value;
+    return true;
+}
+
+bool linear_add(Linear* map, const char* key, long value) {
+    if(map->len + 1 > map->capacity * 0.75) {
+        linear_grow(map, map->capacity == 0 ? 8 : 2 * map->capacity);
+    }
+    LinearEntry* e = linear_find(map->entries, map->capacity, key);
+    bool new_key = e->key == NULL;
+    if(new_key) {
+        map->len++;
+        e->key = strdup(key);
+    }
+    e->value = value;
+    return new_key;
+}
+
+bool linear_remove(Linear* map, const char* key) {
+    if(map->len == 0) return false;
+    LinearEntry* e = linear_find(map->entries, map->capacity, key);
+    if(e->key == NULL) return false;
+    free((char*)e->key);
+    e->key = NULL;
+    e->value = 1;
+    return true;
+}
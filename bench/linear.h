@@ -0,0 +1,19 @@
+#pragma once
+#include <stdbool.h>
+
+typedef struct {
+    const char* key;
+    long value;
+} LinearEntry;
+
+typedef struct {
+    int len;
+    int capacity;
+    LinearEntry* entries;
+} Linear;
+
+void linear_init(Linear* map);
+void linear_free(Linear* map);
+bool linear_add(Linear* map, const char* key, long value);
+bool linear_get(Linear* map, const char* key, long* value);
+bool linear_remove(Linear* map, const char* key);
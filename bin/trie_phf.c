@@ -0,0 +1,423 @@
+#include <stdint.h>
+#include <string.h>
+#include "trie.h"
+
+/* auto-generated by triegen.py --phf */
+
+#define PHF_KEYS 366
+#define PHF_BUCKETS 256
+
+static const uint16_t phf_disp[PHF_BUCKETS] = {
+  0, 0, 0, 0, 0, 0, 5, 3, 0, 10, 0, 11,
+  0, 3, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0,
+  0, 0, 5, 4, 1, 0, 0, 0, 0, 1, 0, 0,
+  1, 2, 0, 1, 2, 1, 2, 0, 0, 1, 5, 4,
+  0, 3, 0, 0, 1, 2, 0, 0, 0, 0, 1, 1,
+  0, 0, 0, 6, 4, 4, 0, 0, 0, 5, 4, 4,
+  17, 4, 0, 4, 0, 4, 0, 7, 0, 0, 0, 0,
+  5, 0, 0, 0, 0, 9, 6, 0, 0, 0, 3, 5,
+  0, 18, 6, 3, 1, 13, 0, 4, 4, 3, 0, 0,
+  6, 16, 7, 1, 4, 3, 0, 3, 4, 15, 0, 13,
+  0, 1, 0, 0, 2, 6, 0, 0, 1, 10, 2, 0,
+  0, 4, 0, 0, 6, 3, 3, 11, 1, 1, 5, 0,
+  0, 12, 11, 3, 5, 13, 0, 1, 5, 17, 0, 0,
+  0, 38, 1, 0, 0, 0, 16, 7, 0, 3, 1, 9,
+  3, 0, 4, 15, 0, 9, 0, 3, 0, 0, 3, 31,
+  8, 0, 8, 0, 0, 10, 23, 9, 9, 0, 1, 0,
+  0, 6, 9, 18, 7, 0, 0, 2, 2, 12, 14, 0,
+  4, 11, 0, 18, 0, 6, 0, 13, 0, 2, 0, 16,
+  0, 0, 0, 0, 112, 2, 6, 11, 54, 105, 0, 1,
+  48, 164, 32, 2, 0, 13, 35, 4, 43, 0, 1, 112,
+  0, 5, 1, 0, 21, 2, 0, 215, 21, 0, 3, 0,
+  0, 0, 296, 0,
+};
+
+static const struct { const char* name; uint8_t len; long value; } phf_table[PHF_KEYS] = {
+  {"move_pages", 10, 279},
+  {"readlink", 8, 89},
+  {".cpy", 4, C_CPY},
+  {"gettimeofday", 12, 96},
+  {".free", 5, C_FREE},
+  {".deref", 6, C_DEREF},
+  {"sched_setattr", 13, 314},
+  {"inotify_rm_watch", 16, 255},
+  {"msgctl", 6, 71},
+  {".memstat", 8, C_MEMSTAT},
+  {"memfd_create", 12, 319},
+  {".unpack", 7, C_UNPACK},
+  {".join", 5, C_JOIN},
+  {"symlinkat", 9, 266},
+  {"lremovexattr", 12, 198},
+  {"utimes", 6, 235},
+  {"semtimedop", 10, 220},
+  {"getpgrp", 7, 111},
+  {"sendmmsg", 8, 307},
+  {"geteuid", 7, 107},
+  {"ustat", 5, 136},
+  {"fcntl", 5, 72},
+  {"shmctl", 6, 31},
+  {"utimensat", 9, 280},
+  {"create_module", 13, 174},
+  {"futimesat", 9, 261},
+  {"getpeername", 11, 52},
+  {"sched_getattr", 13, 315},
+  {"remap_file_pages", 16, 216},
+  {"setresgid", 9, 119},
+  {"timer_getoverrun", 16, 225},
+  {"madvise", 7, 28},
+  {".load8", 6, C_LOAD8},
+  {"adjtimex", 8, 159},
+  {"pselect6", 8, 270},
+  {"brk", 3, 12},
+  {"fchownat", 8, 260},
+  {"personality", 11, 135},
+  {"pkey_free", 9, 331},
+  {"mq_notify", 9, 244},
+  {"gettid", 6, 186},
+  {"recvfrom", 8, 45},
+  {".store32", 8, C_STORE32},
+  {"io_cancel", 9, 210},
+  {"getrlimit", 9, 97},
+  {"mq_open", 7, 240},
+  {"getpid", 6, 39},
+  {"setgroups", 9, 116},
+  {"fanotify_mark", 13, 301},
+  {"listxattr", 9, 194},
+  {"timerfd_create", 14, 283},
+  {"getresgid", 9, 120},
+  {"fsync", 5, 74},
+  {"mq_timedsend", 12, 242},
+  {"set_thread_area", 15, 205},
+  {"flistxattr", 10, 196},
+  {"iopl", 4, 172},
+  {"munlockall", 10, 152},
+  {"link", 4, 86},
+  {"vfork", 5, 58},
+  {"sethostname", 11, 170},
+  {".count", 6, C_COUNT},
+  {"rt_sigpending", 13, 127},
+  {"setreuid", 8, 113},
+  {"rename", 6, 82},
+  {"fdatasync", 9, 75},
+  {"lookup_dcookie", 14, 212},
+  {"munlock", 7, 150},
+  {"access", 6, 21},
+  {"fchmodat", 8, 268},
+  {"linkat", 6, 265},
+  {"sched_get_priority_max", 22, 146},
+  {"getcwd", 6, 79},
+  {"quotactl", 8, 179},
+  {"utime", 5, 132},
+  {"sync_file_range", 15, 277},
+  {"getgid", 6, 104},
+  {"epoll_create", 12, 213},
+  {"getrusage", 9, 98},
+  {"openat", 6, 257},
+  {"process_vm_readv", 16, 310},
+  {"ptrace", 6, 101},
+  {"eventfd", 7, 284},
+  {"getcpu", 6, 309},
+  {"lsetxattr", 9, 189},
+  {".spawn", 6, C_SPAWN},
+  {"truncate", 8, 76},
+  {"select", 6, 23},
+  {"newfstatat", 10, 262},
+  {"signalfd4", 9, 289},
+  {"epoll_wait", 10, 232},
+  {"clock_nanosleep", 15, 230},
+  {"ioperm", 6, 173},
+  {".add", 4, C_ADD},
+  {"lchown", 6, 94},
+  {"getsockname", 11, 51},
+  {"arch_prctl", 10, 158},
+  {"mq_timedreceive", 15, 243},
+  {"waitid", 6, 247},
+  {"time", 4, 201},
+  {"stat", 4, 4},
+  {"fstat", 5, 5},
+  {"creat", 5, 85},
+  {"query_module", 12, 178},
+  {"signalfd", 8, 282},
+  {"io_destroy", 10, 207},
+  {"ppoll", 5, 271},
+  {"mknod", 5, 133},
+  {".mul", 4, C_MUL},
+  {"open", 4, 2},
+  {"msgget", 6, 68},
+  {"getgroups", 9, 115},
+  {"umask", 5, 95},
+  {"sendto", 6, 44},
+  {"pause", 5, 34},
+  {"exit_group", 10, 231},
+  {"kexec_load", 10, 246},
+  {"tgkill", 6, 234},
+  {".fill", 5, C_FILL},
+  {"socketpair", 10, 53},
+  {"msgsnd", 6, 69},
+  {"afs_syscall", 11, 183},
+  {"clock_adjtime", 13, 305},
+  {"renameat", 8, 264},
+  {"chown", 5, 92},
+  {"bind", 4, 49},
+  {"lgetxattr", 9, 192},
+  {"prlimit64", 9, 302},
+  {"semctl", 6, 66},
+  {"fstatfs", 7, 138},
+  {"pwrite64", 8, 18},
+  {"setgid", 6, 106},
+  {"rmdir", 5, 84},
+  {"epoll_ctl", 9, 233},
+  {".load16", 7, C_LOAD16},
+  {"fchdir", 6, 81},
+  {"exit", 4, 60},
+  {"umount2", 7, 166},
+  {"symlink", 7, 88},
+  {"epoll_create1", 13, 291},
+  {"pwritev", 7, 296},
+  {"userfaultfd", 11, 323},
+  {"splice", 6, 275},
+  {"chroot", 6, 161},
+  {"mknodat", 7, 259},
+  {"getxattr", 8, 191},
+  {".pack", 5, C_PACK},
+  {"uselib", 6, 134},
+  {"sched_getscheduler", 18, 145},
+  {".set", 4, C_SET},
+  {"setns", 5, 308},
+  {"sched_getaffinity", 17, 204},
+  {"recvmmsg", 8, 299},
+  {"accept", 6, 43},
+  {"setitimer", 9, 38},
+  {".store16", 8, C_STORE16},
+  {"readlinkat", 10, 267},
+  {"pipe", 4, 22},
+  {"timer_create", 12, 222},
+  {"mmap", 4, 9},
+  {"pkey_alloc", 10, 330},
+  {"get_robust_list", 15, 274},
+  {"modify_ldt", 10, 154},
+  {"fsetxattr", 9, 190},
+  {"fork", 4, 57},
+  {"preadv", 6, 295},
+  {"fadvise64", 9, 221},
+  {"clock_settime", 13, 227},
+  {"unlinkat", 8, 263},
+  {"open_by_handle_at", 17, 304},
+  {"lstat", 5, 6},
+  {".store64", 8, C_STORE64},
+  {"kexec_file_load", 15, 320},
+  {"inotify_init", 12, 253},
+  {"set_tid_address", 15, 218},
+  {"init_module", 11, 175},
+  {".alloc", 6, C_ALLOC},
+  {"getresuid", 9, 118},
+  {"futex", 5, 202},
+  {"flock", 5, 73},
+  {"setxattr", 8, 188},
+  {"timerfd_gettime", 15, 287},
+  {"getpriority", 11, 140},
+  {"accept4", 7, 288},
+  {".if", 3, C_IF},
+  {"shutdown", 8, 48},
+  {"delete_module", 13, 176},
+  {"get_mempolicy", 13, 239},
+  {"tee", 3, 276},
+  {"semop", 5, 65},
+  {"acct", 4, 163},
+  {"epoll_ctl_old", 13, 214},
+  {"setsockopt", 10, 54},
+  {"getpmsg", 7, 181},
+  {"lseek", 5, 8},
+  {"mq_getsetattr", 13, 245},
+  {"chdir", 5, 80},
+  {"membarrier", 10, 324},
+  {"name_to_handle_at", 17, 303},
+  {"poll", 4, 7},
+  {"mkdirat", 7, 258},
+  {".cmp", 4, C_CMP},
+  {"rt_tgsigqueueinfo", 17, 297},
+  {"connect", 7, 42},
+  {"mbind", 5, 237},
+  {"request_key", 11, 249},
+  {"getdents64", 10, 217},
+  {"mlock", 5, 149},
+  {"syslog", 6, 103},
+  {".pump", 5, C_PUMP},
+  {"clone", 5, 56},
+  {"sched_get_priority_min", 22, 147},
+  {"msync", 5, 26},
+  {"sendfile", 8, 40},
+  {"capset", 6, 126},
+  {"set_mempolicy", 13, 238},
+  {"readahead", 9, 187},
+  {"msgrcv", 6, 70},
+  {"getuid", 6, 102},
+  {"setregid", 8, 114},
+  {".while", 6, C_WHILE},
+  {"inotify_add_watch", 17, 254},
+  {"getitimer", 9, 36},
+  {".pspawn", 7, C_PSPAWN},
+  {".realloc", 8, C_REALLOC},
+  {"sched_setaffinity", 17, 203},
+  {"fremovexattr", 12, 199},
+  {"getrandom", 9, 318},
+  {"ioctl", 5, 16},
+  {"ioprio_get", 10, 252},
+  {"nanosleep", 9, 35},
+  {"syncfs", 6, 306},
+  {"timer_delete", 12, 226},
+  {"io_setup", 8, 206},
+  {".load64", 7, C_LOAD64},
+  {"vhangup", 7, 153},
+  {"fchown", 6, 93},
+  {"sched_rr_get_interval", 21, 148},
+  {"setsid", 6, 112},
+  {"timer_gettime", 13, 224},
+  {"shmget", 6, 29},
+  {"shmat", 5, 30},
+  {"epoll_wait_old", 14, 215},
+  {"tuxcall", 7, 184},
+  {"timerfd_settime", 15, 286},
+  {"copy_file_range", 15, 326},
+  {"sched_getparam", 14, 143},
+  {"getppid", 7, 110},
+  {"getsockopt", 10, 55},
+  {"socket", 6, 41},
+  {"clock_getres", 12, 229},
+  {"settimeofday", 12, 164},
+  {"setresuid", 9, 117},
+  {"kill", 4, 62},
+  {"write", 5, 1},
+  {"sysinfo", 7, 99},
+  {"execve", 6, 59},
+  {"pivot_root", 10, 155},
+  {"sched_setscheduler", 18, 144},
+  {"times", 5, 100},
+  {"setfsgid", 8, 123},
+  {"get_kernel_syms", 15, 177},
+  {"chmod", 5, 90},
+  {"setdomainname", 13, 171},
+  {"llistxattr", 10, 195},
+  {"statfs", 6, 137},
+  {"mlockall", 8, 151},
+  {"sched_setparam", 14, 142},
+  {"putpmsg", 7, 182},
+  {"ftruncate", 9, 77},
+  {".load32", 7, C_LOAD32},
+  {"keyctl", 6, 250},
+  {"writev", 6, 20},
+  {"epoll_pwait", 11, 281},
+  {"fchmod", 6, 91},
+  {"ioprio_set", 10, 251},
+  {"tkill", 5, 200},
+  {"dup", 3, 32},
+  {"setpriority", 11, 141},
+  {".find", 5, C_FIND},
+  {"setfsuid", 8, 122},
+  {"bpf", 3, 321},
+  {"fgetxattr", 9, 193},
+  {"set_robust_list", 15, 273},
+  {".batch", 6, C_BATCH},
+  {"reboot", 6, 169},
+  {"alarm", 5, 37},
+  {"mq_unlink", 9, 241},
+  {"clock_gettime", 13, 228},
+  {"mremap", 6, 25},
+  {"vmsplice", 8, 278},
+  {".sub", 4, C_SUB},
+  {"sendmsg", 7, 46},
+  {"semget", 6, 64},
+  {"wait4", 5, 61},
+  {"listen", 6, 50},
+  {"getsid", 6, 124},
+  {".store8", 7, C_STORE8},
+  {"renameat2", 9, 316},
+  {"getegid", 7, 108},
+  {"rt_sigtimedwait", 15, 128},
+  {"munmap", 6, 11},
+  {"rt_sigprocmask", 14, 14},
+  {"mkdir", 5, 83},
+  {"vserver", 7, 236},
+  {"sigaltstack", 11, 131},
+  {"io_submit", 9, 209},
+  {"unshare", 7, 272},
+  {"rt_sigaction", 12, 13},
+  {"faccessat", 9, 269},
+  {"fallocate", 9, 285},
+  {"read", 4, 0},
+  {"timer_settime", 13, 223},
+  {"execveat", 8, 322},
+  {"mount", 5, 165},
+  {"mlock2", 6, 325},
+  {"pipe2", 5, 293},
+  {"finit_module", 12, 313},
+  {"_sysctl", 7, 156},
+  {"setuid", 6, 105},
+  {"preadv2", 7, 327},
+  {"add_key", 7, 248},
+  {"shmdt", 5, 67},
+  {"io_getevents", 12, 208},
+  {"sched_yield", 11, 24},
+  {"close", 5, 3},
+  {"pkey_mprotect", 13, 329},
+  {"inotify_init1", 13, 294},
+  {"rt_sigsuspend", 13, 130},
+  {"dup3", 4, 292},
+  {"fanotify_init", 13, 300},
+  {"security", 8, 185},
+  {"readv", 5, 19},
+  {"setrlimit", 9, 160},
+  {"unlink", 6, 87},
+  {"rt_sigreturn", 12, 15},
+  {"get_thread_area", 15, 211},
+  {".div", 4, C_DIV},
+  {"recvmsg", 7, 47},
+  {"seccomp", 7, 317},
+  {"setpgid", 7, 109},
+  {"mprotect", 8, 10},
+  {"uname", 5, 63},
+  {"nfsservctl", 10, 180},
+  {"capget", 6, 125},
+  {"pwritev2", 8, 328},
+  {"mincore", 7, 27},
+  {"perf_event_open", 15, 298},
+  {"statx", 5, 332},
+  {"pread64", 7, 17},
+  {"swapoff", 7, 168},
+  {"removexattr", 11, 197},
+  {"restart_syscall", 15, 219},
+  {"rt_sigqueueinfo", 15, 129},
+  {".stats", 6, C_STATS},
+  {"kcmp", 4, 312},
+  {"process_vm_writev", 17, 311},
+  {"migrate_pages", 13, 256},
+  {"prctl", 5, 157},
+  {"getpgid", 7, 121},
+  {"eventfd2", 8, 290},
+  {"sysfs", 5, 139},
+  {"getdents", 8, 78},
+  {"dup2", 4, 33},
+  {"sync", 4, 162},
+  {"swapon", 6, 167},
+};
+
+long trie_phf(const char* key, size_t len) {
+  uint64_t h = len * 0x9e3779b97f4a7c15u;
+  size_t i = 0;
+  uint64_t w;
+  for(; i + 8 <= len; i += 8) {
+    memcpy(&w, key + i, 8);
+    h = (h ^ w) * 0xff51afd7ed558ccdu;
+    h ^= h >> 32;
+  }
+  if(i < len) {
+    w = 0;
+    for(size_t j = i; j < len; j++) w |= (uint64_t)(unsigned char)key[j] << (8 * (j - i));
+    h = (h ^ w) * 0xff51afd7ed558ccdu;
+    h ^= h >> 32;
+  }
+  uint32_t d = phf_disp[(h >> 32) & (PHF_BUCKETS - 1)];
+  uint32_t slot = ((uint64_t)((uint32_t)h ^ (d * 0x9e3779b1u)) * PHF_KEYS) >> 32;
+  if(phf_table[slot].len != len || memcmp(phf_table[slot].name, key, len) != 0) return -1;
+  return phf_table[slot].value;
+}
@@ -0,0 +1,1136 @@
+#include <string.h>
+#include "trie.h"
+
+/* auto-generated by triegen.py */
+
+long trie_switch(const char* key, size_t len) {
+  switch(len > 0 ? key[0] : '\0') {
+    case '.': switch(len > 1 ? key[1] : '\0') {
+      case 'a': switch(len > 2 ? key[2] : '\0') {
+        case 'l': if(len == 6 && memcmp(key + 3, "loc", 3) == 0) { return C_ALLOC; } break;
+        case 'd': if(len == 4 && key[3] == 'd') { return C_ADD; } break;
+      } break;
+      case 'r': if(len == 8 && memcmp(key + 2, "ealloc", 6) == 0) { return C_REALLOC; } break;
+      case 'f': switch(len > 2 ? key[2] : '\0') {
+        case 'r': if(len == 5 && memcmp(key + 3, "ee", 2) == 0) { return C_FREE; } break;
+        case 'i': switch(len > 3 ? key[3] : '\0') {
+          case 'n': if(len == 5 && key[4] == 'd') { return C_FIND; } break;
+          case 'l': if(len == 5 && key[4] == 'l') { return C_FILL; } break;
+        } break;
+      } break;
+      case 's': switch(len > 2 ? key[2] : '\0') {
+        case 'e': if(len == 4 && key[3] == 't') { return C_SET; } break;
+        case 'u': if(len == 4 && key[3] == 'b') { return C_SUB; } break;
+        case 'p': if(len == 6 && memcmp(key + 3, "awn", 3) == 0) { return C_SPAWN; } break;
+        case 't': switch(len > 3 ? key[3] : '\0') {
+          case 'a': if(len == 6 && memcmp(key + 4, "ts", 2) == 0) { return C_STATS; } break;
+          case 'o': switch(len > 4 ? key[4] : '\0') {
+            case 'r': switch(len > 5 ? key[5] : '\0') {
+              case 'e': switch(len > 6 ? key[6] : '\0') {
+                case '8': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return C_STORE8;
+                } break;
+                case '1': if(len == 8 && key[7] == '6') { return C_STORE16; } break;
+                case '3': if(len == 8 && key[7] == '2') { return C_STORE32; } break;
+                case '6': if(len == 8 && key[7] == '4') { return C_STORE64; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'c': switch(len > 2 ? key[2] : '\0') {
+        case 'p': if(len == 4 && key[3] == 'y') { return C_CPY; } break;
+        case 'o': if(len == 6 && memcmp(key + 3, "unt", 3) == 0) { return C_COUNT; } break;
+        case 'm': if(len == 4 && key[3] == 'p') { return C_CMP; } break;
+      } break;
+      case 'd': switch(len > 2 ? key[2] : '\0') {
+        case 'e': if(len == 6 && memcmp(key + 3, "ref", 3) == 0) { return C_DEREF; } break;
+        case 'i': if(len == 4 && key[3] == 'v') { return C_DIV; } break;
+      } break;
+      case 'i': if(len == 3 && key[2] == 'f') { return C_IF; } break;
+      case 'w': if(len == 6 && memcmp(key + 2, "hile", 4) == 0) { return C_WHILE; } break;
+      case 'm': switch(len > 2 ? key[2] : '\0') {
+        case 'u': if(len == 4 && key[3] == 'l') { return C_MUL; } break;
+        case 'e': if(len == 8 && memcmp(key + 3, "mstat", 5) == 0) { return C_MEMSTAT; } break;
+      } break;
+      case 'b': if(len == 6 && memcmp(key + 2, "atch", 4) == 0) { return C_BATCH; } break;
+      case 'j': if(len == 5 && memcmp(key + 2, "oin", 3) == 0) { return C_JOIN; } break;
+      case 'p': switch(len > 2 ? key[2] : '\0') {
+        case 'u': if(len == 5 && memcmp(key + 3, "mp", 2) == 0) { return C_PUMP; } break;
+        case 's': if(len == 7 && memcmp(key + 3, "pawn", 4) == 0) { return C_PSPAWN; } break;
+        case 'a': if(len == 5 && memcmp(key + 3, "ck", 2) == 0) { return C_PACK; } break;
+      } break;
+      case 'l': switch(len > 2 ? key[2] : '\0') {
+        case 'o': switch(len > 3 ? key[3] : '\0') {
+          case 'a': switch(len > 4 ? key[4] : '\0') {
+            case 'd': switch(len > 5 ? key[5] : '\0') {
+              case '8': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return C_LOAD8;
+              } break;
+              case '1': if(len == 7 && key[6] == '6') { return C_LOAD16; } break;
+              case '3': if(len == 7 && key[6] == '2') { return C_LOAD32; } break;
+              case '6': if(len == 7 && key[6] == '4') { return C_LOAD64; } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'u': if(len == 7 && memcmp(key + 2, "npack", 5) == 0) { return C_UNPACK; } break;
+    } break;
+    case 'r': switch(len > 1 ? key[1] : '\0') {
+      case 'e': switch(len > 2 ? key[2] : '\0') {
+        case 'a': switch(len > 3 ? key[3] : '\0') {
+          case 'd': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 0;
+            case 'v': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 19;
+            } break;
+            case 'l': switch(len > 5 ? key[5] : '\0') {
+              case 'i': switch(len > 6 ? key[6] : '\0') {
+                case 'n': switch(len > 7 ? key[7] : '\0') {
+                  case 'k': switch(len > 8 ? key[8] : '\0') {
+                    case '\x00': return 89;
+                    case 'a': if(len == 10 && key[9] == 't') { return 267; } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+            case 'a': if(len == 9 && memcmp(key + 5, "head", 4) == 0) { return 187; } break;
+          } break;
+        } break;
+        case 'c': switch(len > 3 ? key[3] : '\0') {
+          case 'v': switch(len > 4 ? key[4] : '\0') {
+            case 'f': if(len == 8 && memcmp(key + 5, "rom", 3) == 0) { return 45; } break;
+            case 'm': switch(len > 5 ? key[5] : '\0') {
+              case 's': if(len == 7 && key[6] == 'g') { return 47; } break;
+              case 'm': if(len == 8 && memcmp(key + 6, "sg", 2) == 0) { return 299; } break;
+            } break;
+          } break;
+        } break;
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'a': switch(len > 4 ? key[4] : '\0') {
+            case 'm': switch(len > 5 ? key[5] : '\0') {
+              case 'e': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 82;
+                case 'a': switch(len > 7 ? key[7] : '\0') {
+                  case 't': switch(len > 8 ? key[8] : '\0') {
+                    case '\x00': return 264;
+                    case '2': switch(len > 9 ? key[9] : '\0') {
+                      case '\x00': return 316;
+                    } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case 'b': if(len == 6 && memcmp(key + 3, "oot", 3) == 0) { return 169; } break;
+        case 'm': switch(len > 3 ? key[3] : '\0') {
+          case 'o': if(len == 11 && memcmp(key + 4, "vexattr", 7) == 0) { return 197; } break;
+          case 'a': if(len == 16 && memcmp(key + 4, "p_file_pages", 12) == 0) { return 216; } break;
+        } break;
+        case 's': if(len == 15 && memcmp(key + 3, "tart_syscall", 12) == 0) { return 219; } break;
+        case 'q': if(len == 11 && memcmp(key + 3, "uest_key", 8) == 0) { return 249; } break;
+      } break;
+      case 't': switch(len > 2 ? key[2] : '\0') {
+        case '_': switch(len > 3 ? key[3] : '\0') {
+          case 's': switch(len > 4 ? key[4] : '\0') {
+            case 'i': switch(len > 5 ? key[5] : '\0') {
+              case 'g': switch(len > 6 ? key[6] : '\0') {
+                case 'a': if(len == 12 && memcmp(key + 7, "ction", 5) == 0) { return 13; } break;
+                case 'p': switch(len > 7 ? key[7] : '\0') {
+                  case 'r': if(len == 14 && memcmp(key + 8, "ocmask", 6) == 0) { return 14; } break;
+                  case 'e': if(len == 13 && memcmp(key + 8, "nding", 5) == 0) { return 127; } break;
+                } break;
+                case 'r': if(len == 12 && memcmp(key + 7, "eturn", 5) == 0) { return 15; } break;
+                case 't': if(len == 15 && memcmp(key + 7, "imedwait", 8) == 0) { return 128; } break;
+                case 'q': if(len == 15 && memcmp(key + 7, "ueueinfo", 8) == 0) { return 129; } break;
+                case 's': if(len == 13 && memcmp(key + 7, "uspend", 6) == 0) { return 130; } break;
+              } break;
+            } break;
+          } break;
+          case 't': if(len == 17 && memcmp(key + 4, "gsigqueueinfo", 13) == 0) { return 297; } break;
+        } break;
+      } break;
+      case 'm': if(len == 5 && memcmp(key + 2, "dir", 3) == 0) { return 84; } break;
+    } break;
+    case 'w': switch(len > 1 ? key[1] : '\0') {
+      case 'r': switch(len > 2 ? key[2] : '\0') {
+        case 'i': switch(len > 3 ? key[3] : '\0') {
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 1;
+              case 'v': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 20;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'a': switch(len > 2 ? key[2] : '\0') {
+        case 'i': switch(len > 3 ? key[3] : '\0') {
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case '4': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 61;
+            } break;
+            case 'i': if(len == 6 && key[5] == 'd') { return 247; } break;
+          } break;
+        } break;
+      } break;
+    } break;
+    case 'o': switch(len > 1 ? key[1] : '\0') {
+      case 'p': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'n': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 2;
+            case 'a': if(len == 6 && key[5] == 't') { return 257; } break;
+            case '_': if(len == 17 && memcmp(key + 5, "by_handle_at", 12) == 0) { return 304; } break;
+          } break;
+        } break;
+      } break;
+    } break;
+    case 'c': switch(len > 1 ? key[1] : '\0') {
+      case 'l': switch(len > 2 ? key[2] : '\0') {
+        case 'o': switch(len > 3 ? key[3] : '\0') {
+          case 's': if(len == 5 && key[4] == 'e') { return 3; } break;
+          case 'n': if(len == 5 && key[4] == 'e') { return 56; } break;
+          case 'c': switch(len > 4 ? key[4] : '\0') {
+            case 'k': switch(len > 5 ? key[5] : '\0') {
+              case '_': switch(len > 6 ? key[6] : '\0') {
+                case 's': if(len == 13 && memcmp(key + 7, "ettime", 6) == 0) { return 227; } break;
+                case 'g': switch(len > 7 ? key[7] : '\0') {
+                  case 'e': switch(len > 8 ? key[8] : '\0') {
+                    case 't': switch(len > 9 ? key[9] : '\0') {
+                      case 't': if(len == 13 && memcmp(key + 10, "ime", 3) == 0) { return 228; } break;
+                      case 'r': if(len == 12 && memcmp(key + 10, "es", 2) == 0) { return 229; } break;
+                    } break;
+                  } break;
+                } break;
+                case 'n': if(len == 15 && memcmp(key + 7, "anosleep", 8) == 0) { return 230; } break;
+                case 'a': if(len == 13 && memcmp(key + 7, "djtime", 6) == 0) { return 305; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'o': switch(len > 2 ? key[2] : '\0') {
+        case 'n': if(len == 7 && memcmp(key + 3, "nect", 4) == 0) { return 42; } break;
+        case 'p': if(len == 15 && memcmp(key + 3, "y_file_range", 12) == 0) { return 326; } break;
+      } break;
+      case 'h': switch(len > 2 ? key[2] : '\0') {
+        case 'd': if(len == 5 && memcmp(key + 3, "ir", 2) == 0) { return 80; } break;
+        case 'm': if(len == 5 && memcmp(key + 3, "od", 2) == 0) { return 90; } break;
+        case 'o': if(len == 5 && memcmp(key + 3, "wn", 2) == 0) { return 92; } break;
+        case 'r': if(len == 6 && memcmp(key + 3, "oot", 3) == 0) { return 161; } break;
+      } break;
+      case 'r': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'a': switch(len > 4 ? key[4] : '\0') {
+            case 't': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 85;
+              case 'e': if(len == 13 && memcmp(key + 6, "_module", 7) == 0) { return 174; } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'a': switch(len > 2 ? key[2] : '\0') {
+        case 'p': switch(len > 3 ? key[3] : '\0') {
+          case 'g': if(len == 6 && memcmp(key + 4, "et", 2) == 0) { return 125; } break;
+          case 's': if(len == 6 && memcmp(key + 4, "et", 2) == 0) { return 126; } break;
+        } break;
+      } break;
+    } break;
+    case 's': switch(len > 1 ? key[1] : '\0') {
+      case 't': switch(len > 2 ? key[2] : '\0') {
+        case 'a': switch(len > 3 ? key[3] : '\0') {
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 4;
+            case 'f': if(len == 6 && key[5] == 's') { return 137; } break;
+            case 'x': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 332;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'e': switch(len > 2 ? key[2] : '\0') {
+        case 'l': if(len == 6 && memcmp(key + 3, "ect", 3) == 0) { return 23; } break;
+        case 't': switch(len > 3 ? key[3] : '\0') {
+          case 'i': if(len == 9 && memcmp(key + 4, "timer", 5) == 0) { return 38; } break;
+          case 's': switch(len > 4 ? key[4] : '\0') {
+            case 'o': if(len == 10 && memcmp(key + 5, "ckopt", 5) == 0) { return 54; } break;
+            case 'i': if(len == 6 && key[5] == 'd') { return 112; } break;
+          } break;
+          case 'u': if(len == 6 && memcmp(key + 4, "id", 2) == 0) { return 105; } break;
+          case 'g': switch(len > 4 ? key[4] : '\0') {
+            case 'i': if(len == 6 && key[5] == 'd') { return 106; } break;
+            case 'r': if(len == 9 && memcmp(key + 5, "oups", 4) == 0) { return 116; } break;
+          } break;
+          case 'p': switch(len > 4 ? key[4] : '\0') {
+            case 'g': if(len == 7 && memcmp(key + 5, "id", 2) == 0) { return 109; } break;
+            case 'r': if(len == 11 && memcmp(key + 5, "iority", 6) == 0) { return 141; } break;
+          } break;
+          case 'r': switch(len > 4 ? key[4] : '\0') {
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case 'u': if(len == 8 && memcmp(key + 6, "id", 2) == 0) { return 113; } break;
+              case 'g': if(len == 8 && memcmp(key + 6, "id", 2) == 0) { return 114; } break;
+              case 's': switch(len > 6 ? key[6] : '\0') {
+                case 'u': if(len == 9 && memcmp(key + 7, "id", 2) == 0) { return 117; } break;
+                case 'g': if(len == 9 && memcmp(key + 7, "id", 2) == 0) { return 119; } break;
+              } break;
+            } break;
+            case 'l': if(len == 9 && memcmp(key + 5, "imit", 4) == 0) { return 160; } break;
+          } break;
+          case 'f': switch(len > 4 ? key[4] : '\0') {
+            case 's': switch(len > 5 ? key[5] : '\0') {
+              case 'u': if(len == 8 && memcmp(key + 6, "id", 2) == 0) { return 122; } break;
+              case 'g': if(len == 8 && memcmp(key + 6, "id", 2) == 0) { return 123; } break;
+            } break;
+          } break;
+          case 't': if(len == 12 && memcmp(key + 4, "imeofday", 8) == 0) { return 164; } break;
+          case 'h': if(len == 11 && memcmp(key + 4, "ostname", 7) == 0) { return 170; } break;
+          case 'd': if(len == 13 && memcmp(key + 4, "omainname", 9) == 0) { return 171; } break;
+          case 'x': if(len == 8 && memcmp(key + 4, "attr", 4) == 0) { return 188; } break;
+          case '_': switch(len > 4 ? key[4] : '\0') {
+            case 't': switch(len > 5 ? key[5] : '\0') {
+              case 'h': if(len == 15 && memcmp(key + 6, "read_area", 9) == 0) { return 205; } break;
+              case 'i': if(len == 15 && memcmp(key + 6, "d_address", 9) == 0) { return 218; } break;
+            } break;
+            case 'm': if(len == 13 && memcmp(key + 5, "empolicy", 8) == 0) { return 238; } break;
+            case 'r': if(len == 15 && memcmp(key + 5, "obust_list", 10) == 0) { return 273; } break;
+          } break;
+          case 'n': if(len == 5 && key[4] == 's') { return 308; } break;
+        } break;
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'd': switch(len > 4 ? key[4] : '\0') {
+            case 'f': if(len == 8 && memcmp(key + 5, "ile", 3) == 0) { return 40; } break;
+            case 't': if(len == 6 && key[5] == 'o') { return 44; } break;
+            case 'm': switch(len > 5 ? key[5] : '\0') {
+              case 's': if(len == 7 && key[6] == 'g') { return 46; } break;
+              case 'm': if(len == 8 && memcmp(key + 6, "sg", 2) == 0) { return 307; } break;
+            } break;
+          } break;
+        } break;
+        case 'm': switch(len > 3 ? key[3] : '\0') {
+          case 'g': if(len == 6 && memcmp(key + 4, "et", 2) == 0) { return 64; } break;
+          case 'o': if(len == 5 && key[4] == 'p') { return 65; } break;
+          case 'c': if(len == 6 && memcmp(key + 4, "tl", 2) == 0) { return 66; } break;
+          case 't': if(len == 10 && memcmp(key + 4, "imedop", 6) == 0) { return 220; } break;
+        } break;
+        case 'c': switch(len > 3 ? key[3] : '\0') {
+          case 'u': if(len == 8 && memcmp(key + 4, "rity", 4) == 0) { return 185; } break;
+          case 'c': if(len == 7 && memcmp(key + 4, "omp", 3) == 0) { return 317; } break;
+        } break;
+      } break;
+      case 'c': switch(len > 2 ? key[2] : '\0') {
+        case 'h': switch(len > 3 ? key[3] : '\0') {
+          case 'e': switch(len > 4 ? key[4] : '\0') {
+            case 'd': switch(len > 5 ? key[5] : '\0') {
+              case '_': switch(len > 6 ? key[6] : '\0') {
+                case 'y': if(len == 11 && memcmp(key + 7, "ield", 4) == 0) { return 24; } break;
+                case 's': switch(len > 7 ? key[7] : '\0') {
+                  case 'e': switch(len > 8 ? key[8] : '\0') {
+                    case 't': switch(len > 9 ? key[9] : '\0') {
+                      case 'p': if(len == 14 && memcmp(key + 10, "aram", 4) == 0) { return 142; } break;
+                      case 's': if(len == 18 && memcmp(key + 10, "cheduler", 8) == 0) { return 144; } break;
+                      case 'a': switch(len > 10 ? key[10] : '\0') {
+                        case 'f': if(len == 17 && memcmp(key + 11, "finity", 6) == 0) { return 203; } break;
+                        case 't': if(len == 13 && memcmp(key + 11, "tr", 2) == 0) { return 314; } break;
+                      } break;
+                    } break;
+                  } break;
+                } break;
+                case 'g': switch(len > 7 ? key[7] : '\0') {
+                  case 'e': switch(len > 8 ? key[8] : '\0') {
+                    case 't': switch(len > 9 ? key[9] : '\0') {
+                      case 'p': if(len == 14 && memcmp(key + 10, "aram", 4) == 0) { return 143; } break;
+                      case 's': if(len == 18 && memcmp(key + 10, "cheduler", 8) == 0) { return 145; } break;
+                      case '_': switch(len > 10 ? key[10] : '\0') {
+                        case 'p': switch(len > 11 ? key[11] : '\0') {
+                          case 'r': switch(len > 12 ? key[12] : '\0') {
+                            case 'i': switch(len > 13 ? key[13] : '\0') {
+                              case 'o': switch(len > 14 ? key[14] : '\0') {
+                                case 'r': switch(len > 15 ? key[15] : '\0') {
+                                  case 'i': switch(len > 16 ? key[16] : '\0') {
+                                    case 't': switch(len > 17 ? key[17] : '\0') {
+                                      case 'y': switch(len > 18 ? key[18] : '\0') {
+                                        case '_': switch(len > 19 ? key[19] : '\0') {
+                                          case 'm': switch(len > 20 ? key[20] : '\0') {
+                                            case 'a': if(len == 22 && key[21] == 'x') { return 146; } break;
+                                            case 'i': if(len == 22 && key[21] == 'n') { return 147; } break;
+                                          } break;
+                                        } break;
+                                      } break;
+                                    } break;
+                                  } break;
+                                } break;
+                              } break;
+                            } break;
+                          } break;
+                        } break;
+                      } break;
+                      case 'a': switch(len > 10 ? key[10] : '\0') {
+                        case 'f': if(len == 17 && memcmp(key + 11, "finity", 6) == 0) { return 204; } break;
+                        case 't': if(len == 13 && memcmp(key + 11, "tr", 2) == 0) { return 315; } break;
+                      } break;
+                    } break;
+                  } break;
+                } break;
+                case 'r': if(len == 21 && memcmp(key + 7, "r_get_interval", 14) == 0) { return 148; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'h': switch(len > 2 ? key[2] : '\0') {
+        case 'm': switch(len > 3 ? key[3] : '\0') {
+          case 'g': if(len == 6 && memcmp(key + 4, "et", 2) == 0) { return 29; } break;
+          case 'a': if(len == 5 && key[4] == 't') { return 30; } break;
+          case 'c': if(len == 6 && memcmp(key + 4, "tl", 2) == 0) { return 31; } break;
+          case 'd': if(len == 5 && key[4] == 't') { return 67; } break;
+        } break;
+        case 'u': if(len == 8 && memcmp(key + 3, "tdown", 5) == 0) { return 48; } break;
+      } break;
+      case 'o': switch(len > 2 ? key[2] : '\0') {
+        case 'c': switch(len > 3 ? key[3] : '\0') {
+          case 'k': switch(len > 4 ? key[4] : '\0') {
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case 't': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 41;
+                case 'p': if(len == 10 && memcmp(key + 7, "air", 3) == 0) { return 53; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'y': switch(len > 2 ? key[2] : '\0') {
+        case 'm': switch(len > 3 ? key[3] : '\0') {
+          case 'l': switch(len > 4 ? key[4] : '\0') {
+            case 'i': switch(len > 5 ? key[5] : '\0') {
+              case 'n': switch(len > 6 ? key[6] : '\0') {
+                case 'k': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return 88;
+                  case 'a': if(len == 9 && key[8] == 't') { return 266; } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case 's': switch(len > 3 ? key[3] : '\0') {
+          case 'i': if(len == 7 && memcmp(key + 4, "nfo", 3) == 0) { return 99; } break;
+          case 'l': if(len == 6 && memcmp(key + 4, "og", 2) == 0) { return 103; } break;
+          case 'f': if(len == 5 && key[4] == 's') { return 139; } break;
+        } break;
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'c': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 162;
+            case '_': if(len == 15 && memcmp(key + 5, "file_range", 10) == 0) { return 277; } break;
+            case 'f': if(len == 6 && key[5] == 's') { return 306; } break;
+          } break;
+        } break;
+      } break;
+      case 'i': switch(len > 2 ? key[2] : '\0') {
+        case 'g': switch(len > 3 ? key[3] : '\0') {
+          case 'a': if(len == 11 && memcmp(key + 4, "ltstack", 7) == 0) { return 131; } break;
+          case 'n': switch(len > 4 ? key[4] : '\0') {
+            case 'a': switch(len > 5 ? key[5] : '\0') {
+              case 'l': switch(len > 6 ? key[6] : '\0') {
+                case 'f': switch(len > 7 ? key[7] : '\0') {
+                  case 'd': switch(len > 8 ? key[8] : '\0') {
+                    case '\x00': return 282;
+                    case '4': switch(len > 9 ? key[9] : '\0') {
+                      case '\x00': return 289;
+                    } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'w': switch(len > 2 ? key[2] : '\0') {
+        case 'a': switch(len > 3 ? key[3] : '\0') {
+          case 'p': switch(len > 4 ? key[4] : '\0') {
+            case 'o': switch(len > 5 ? key[5] : '\0') {
+              case 'n': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 167;
+              } break;
+              case 'f': if(len == 7 && key[6] == 'f') { return 168; } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'p': if(len == 6 && memcmp(key + 2, "lice", 4) == 0) { return 275; } break;
+    } break;
+    case 'f': switch(len > 1 ? key[1] : '\0') {
+      case 's': switch(len > 2 ? key[2] : '\0') {
+        case 't': switch(len > 3 ? key[3] : '\0') {
+          case 'a': switch(len > 4 ? key[4] : '\0') {
+            case 't': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 5;
+              case 'f': if(len == 7 && key[6] == 's') { return 138; } break;
+            } break;
+          } break;
+        } break;
+        case 'y': if(len == 5 && memcmp(key + 3, "nc", 2) == 0) { return 74; } break;
+        case 'e': if(len == 9 && memcmp(key + 3, "txattr", 6) == 0) { return 190; } break;
+      } break;
+      case 'o': if(len == 4 && memcmp(key + 2, "rk", 2) == 0) { return 57; } break;
+      case 'c': switch(len > 2 ? key[2] : '\0') {
+        case 'n': if(len == 5 && memcmp(key + 3, "tl", 2) == 0) { return 72; } break;
+        case 'h': switch(len > 3 ? key[3] : '\0') {
+          case 'd': if(len == 6 && memcmp(key + 4, "ir", 2) == 0) { return 81; } break;
+          case 'm': switch(len > 4 ? key[4] : '\0') {
+            case 'o': switch(len > 5 ? key[5] : '\0') {
+              case 'd': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 91;
+                case 'a': if(len == 8 && key[7] == 't') { return 268; } break;
+              } break;
+            } break;
+          } break;
+          case 'o': switch(len > 4 ? key[4] : '\0') {
+            case 'w': switch(len > 5 ? key[5] : '\0') {
+              case 'n': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 93;
+                case 'a': if(len == 8 && key[7] == 't') { return 260; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'l': switch(len > 2 ? key[2] : '\0') {
+        case 'o': if(len == 5 && memcmp(key + 3, "ck", 2) == 0) { return 73; } break;
+        case 'i': if(len == 10 && memcmp(key + 3, "stxattr", 7) == 0) { return 196; } break;
+      } break;
+      case 'd': if(len == 9 && memcmp(key + 2, "atasync", 7) == 0) { return 75; } break;
+      case 't': if(len == 9 && memcmp(key + 2, "runcate", 7) == 0) { return 77; } break;
+      case 'g': if(len == 9 && memcmp(key + 2, "etxattr", 7) == 0) { return 193; } break;
+      case 'r': if(len == 12 && memcmp(key + 2, "emovexattr", 10) == 0) { return 199; } break;
+      case 'u': switch(len > 2 ? key[2] : '\0') {
+        case 't': switch(len > 3 ? key[3] : '\0') {
+          case 'e': if(len == 5 && key[4] == 'x') { return 202; } break;
+          case 'i': if(len == 9 && memcmp(key + 4, "mesat", 5) == 0) { return 261; } break;
+        } break;
+      } break;
+      case 'a': switch(len > 2 ? key[2] : '\0') {
+        case 'd': if(len == 9 && memcmp(key + 3, "vise64", 6) == 0) { return 221; } break;
+        case 'c': if(len == 9 && memcmp(key + 3, "cessat", 6) == 0) { return 269; } break;
+        case 'l': if(len == 9 && memcmp(key + 3, "locate", 6) == 0) { return 285; } break;
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'o': switch(len > 4 ? key[4] : '\0') {
+            case 't': switch(len > 5 ? key[5] : '\0') {
+              case 'i': switch(len > 6 ? key[6] : '\0') {
+                case 'f': switch(len > 7 ? key[7] : '\0') {
+                  case 'y': switch(len > 8 ? key[8] : '\0') {
+                    case '_': switch(len > 9 ? key[9] : '\0') {
+                      case 'i': if(len == 13 && memcmp(key + 10, "nit", 3) == 0) { return 300; } break;
+                      case 'm': if(len == 13 && memcmp(key + 10, "ark", 3) == 0) { return 301; } break;
+                    } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'i': if(len == 12 && memcmp(key + 2, "nit_module", 10) == 0) { return 313; } break;
+    } break;
+    case 'l': switch(len > 1 ? key[1] : '\0') {
+      case 's': switch(len > 2 ? key[2] : '\0') {
+        case 't': if(len == 5 && memcmp(key + 3, "at", 2) == 0) { return 6; } break;
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'e': if(len == 5 && key[4] == 'k') { return 8; } break;
+          case 't': if(len == 9 && memcmp(key + 4, "xattr", 5) == 0) { return 189; } break;
+        } break;
+      } break;
+      case 'i': switch(len > 2 ? key[2] : '\0') {
+        case 's': switch(len > 3 ? key[3] : '\0') {
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case 'e': if(len == 6 && key[5] == 'n') { return 50; } break;
+            case 'x': if(len == 9 && memcmp(key + 5, "attr", 4) == 0) { return 194; } break;
+          } break;
+        } break;
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'k': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 86;
+            case 'a': if(len == 6 && key[5] == 't') { return 265; } break;
+          } break;
+        } break;
+      } break;
+      case 'c': if(len == 6 && memcmp(key + 2, "hown", 4) == 0) { return 94; } break;
+      case 'g': if(len == 9 && memcmp(key + 2, "etxattr", 7) == 0) { return 192; } break;
+      case 'l': if(len == 10 && memcmp(key + 2, "istxattr", 8) == 0) { return 195; } break;
+      case 'r': if(len == 12 && memcmp(key + 2, "emovexattr", 10) == 0) { return 198; } break;
+      case 'o': if(len == 14 && memcmp(key + 2, "okup_dcookie", 12) == 0) { return 212; } break;
+    } break;
+    case 'p': switch(len > 1 ? key[1] : '\0') {
+      case 'o': if(len == 4 && memcmp(key + 2, "ll", 2) == 0) { return 7; } break;
+      case 'r': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'a': switch(len > 4 ? key[4] : '\0') {
+            case 'd': switch(len > 5 ? key[5] : '\0') {
+              case '6': if(len == 7 && key[6] == '4') { return 17; } break;
+              case 'v': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 295;
+                case '2': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return 327;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case 'c': if(len == 5 && memcmp(key + 3, "tl", 2) == 0) { return 157; } break;
+        case 'l': if(len == 9 && memcmp(key + 3, "imit64", 6) == 0) { return 302; } break;
+        case 'o': switch(len > 3 ? key[3] : '\0') {
+          case 'c': switch(len > 4 ? key[4] : '\0') {
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case 's': switch(len > 6 ? key[6] : '\0') {
+                case 's': switch(len > 7 ? key[7] : '\0') {
+                  case '_': switch(len > 8 ? key[8] : '\0') {
+                    case 'v': switch(len > 9 ? key[9] : '\0') {
+                      case 'm': switch(len > 10 ? key[10] : '\0') {
+                        case '_': switch(len > 11 ? key[11] : '\0') {
+                          case 'r': if(len == 16 && memcmp(key + 12, "eadv", 4) == 0) { return 310; } break;
+                          case 'w': if(len == 17 && memcmp(key + 12, "ritev", 5) == 0) { return 311; } break;
+                        } break;
+                      } break;
+                    } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'w': switch(len > 2 ? key[2] : '\0') {
+        case 'r': switch(len > 3 ? key[3] : '\0') {
+          case 'i': switch(len > 4 ? key[4] : '\0') {
+            case 't': switch(len > 5 ? key[5] : '\0') {
+              case 'e': switch(len > 6 ? key[6] : '\0') {
+                case '6': if(len == 8 && key[7] == '4') { return 18; } break;
+                case 'v': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return 296;
+                  case '2': switch(len > 8 ? key[8] : '\0') {
+                    case '\x00': return 328;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'i': switch(len > 2 ? key[2] : '\0') {
+        case 'p': switch(len > 3 ? key[3] : '\0') {
+          case 'e': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 22;
+            case '2': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 293;
+            } break;
+          } break;
+        } break;
+        case 'v': if(len == 10 && memcmp(key + 3, "ot_root", 7) == 0) { return 155; } break;
+      } break;
+      case 'a': if(len == 5 && memcmp(key + 2, "use", 3) == 0) { return 34; } break;
+      case 't': if(len == 6 && memcmp(key + 2, "race", 4) == 0) { return 101; } break;
+      case 'e': switch(len > 2 ? key[2] : '\0') {
+        case 'r': switch(len > 3 ? key[3] : '\0') {
+          case 's': if(len == 11 && memcmp(key + 4, "onality", 7) == 0) { return 135; } break;
+          case 'f': if(len == 15 && memcmp(key + 4, "_event_open", 11) == 0) { return 298; } break;
+        } break;
+      } break;
+      case 'u': if(len == 7 && memcmp(key + 2, "tpmsg", 5) == 0) { return 182; } break;
+      case 's': if(len == 8 && memcmp(key + 2, "elect6", 6) == 0) { return 270; } break;
+      case 'p': if(len == 5 && memcmp(key + 2, "oll", 3) == 0) { return 271; } break;
+      case 'k': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'y': switch(len > 4 ? key[4] : '\0') {
+            case '_': switch(len > 5 ? key[5] : '\0') {
+              case 'm': if(len == 13 && memcmp(key + 6, "protect", 7) == 0) { return 329; } break;
+              case 'a': if(len == 10 && memcmp(key + 6, "lloc", 4) == 0) { return 330; } break;
+              case 'f': if(len == 9 && memcmp(key + 6, "ree", 3) == 0) { return 331; } break;
+            } break;
+          } break;
+        } break;
+      } break;
+    } break;
+    case 'm': switch(len > 1 ? key[1] : '\0') {
+      case 'm': if(len == 4 && memcmp(key + 2, "ap", 2) == 0) { return 9; } break;
+      case 'p': if(len == 8 && memcmp(key + 2, "rotect", 6) == 0) { return 10; } break;
+      case 'u': switch(len > 2 ? key[2] : '\0') {
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'm': if(len == 6 && memcmp(key + 4, "ap", 2) == 0) { return 11; } break;
+          case 'l': switch(len > 4 ? key[4] : '\0') {
+            case 'o': switch(len > 5 ? key[5] : '\0') {
+              case 'c': switch(len > 6 ? key[6] : '\0') {
+                case 'k': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return 150;
+                  case 'a': if(len == 10 && memcmp(key + 8, "ll", 2) == 0) { return 152; } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'r': if(len == 6 && memcmp(key + 2, "emap", 4) == 0) { return 25; } break;
+      case 's': switch(len > 2 ? key[2] : '\0') {
+        case 'y': if(len == 5 && memcmp(key + 3, "nc", 2) == 0) { return 26; } break;
+        case 'g': switch(len > 3 ? key[3] : '\0') {
+          case 'g': if(len == 6 && memcmp(key + 4, "et", 2) == 0) { return 68; } break;
+          case 's': if(len == 6 && memcmp(key + 4, "nd", 2) == 0) { return 69; } break;
+          case 'r': if(len == 6 && memcmp(key + 4, "cv", 2) == 0) { return 70; } break;
+          case 'c': if(len == 6 && memcmp(key + 4, "tl", 2) == 0) { return 71; } break;
+        } break;
+      } break;
+      case 'i': switch(len > 2 ? key[2] : '\0') {
+        case 'n': if(len == 7 && memcmp(key + 3, "core", 4) == 0) { return 27; } break;
+        case 'g': if(len == 13 && memcmp(key + 3, "rate_pages", 10) == 0) { return 256; } break;
+      } break;
+      case 'a': if(len == 7 && memcmp(key + 2, "dvise", 5) == 0) { return 28; } break;
+      case 'k': switch(len > 2 ? key[2] : '\0') {
+        case 'd': switch(len > 3 ? key[3] : '\0') {
+          case 'i': switch(len > 4 ? key[4] : '\0') {
+            case 'r': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 83;
+              case 'a': if(len == 7 && key[6] == 't') { return 258; } break;
+            } break;
+          } break;
+        } break;
+        case 'n': switch(len > 3 ? key[3] : '\0') {
+          case 'o': switch(len > 4 ? key[4] : '\0') {
+            case 'd': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 133;
+              case 'a': if(len == 7 && key[6] == 't') { return 259; } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'l': switch(len > 2 ? key[2] : '\0') {
+        case 'o': switch(len > 3 ? key[3] : '\0') {
+          case 'c': switch(len > 4 ? key[4] : '\0') {
+            case 'k': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 149;
+              case 'a': if(len == 8 && memcmp(key + 6, "ll", 2) == 0) { return 151; } break;
+              case '2': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 325;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'o': switch(len > 2 ? key[2] : '\0') {
+        case 'd': if(len == 10 && memcmp(key + 3, "ify_ldt", 7) == 0) { return 154; } break;
+        case 'u': if(len == 5 && memcmp(key + 3, "nt", 2) == 0) { return 165; } break;
+        case 'v': if(len == 10 && memcmp(key + 3, "e_pages", 7) == 0) { return 279; } break;
+      } break;
+      case 'b': if(len == 5 && memcmp(key + 2, "ind", 3) == 0) { return 237; } break;
+      case 'q': switch(len > 2 ? key[2] : '\0') {
+        case '_': switch(len > 3 ? key[3] : '\0') {
+          case 'o': if(len == 7 && memcmp(key + 4, "pen", 3) == 0) { return 240; } break;
+          case 'u': if(len == 9 && memcmp(key + 4, "nlink", 5) == 0) { return 241; } break;
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case 'i': switch(len > 5 ? key[5] : '\0') {
+              case 'm': switch(len > 6 ? key[6] : '\0') {
+                case 'e': switch(len > 7 ? key[7] : '\0') {
+                  case 'd': switch(len > 8 ? key[8] : '\0') {
+                    case 's': if(len == 12 && memcmp(key + 9, "end", 3) == 0) { return 242; } break;
+                    case 'r': if(len == 15 && memcmp(key + 9, "eceive", 6) == 0) { return 243; } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+          case 'n': if(len == 9 && memcmp(key + 4, "otify", 5) == 0) { return 244; } break;
+          case 'g': if(len == 13 && memcmp(key + 4, "etsetattr", 9) == 0) { return 245; } break;
+        } break;
+      } break;
+      case 'e': switch(len > 2 ? key[2] : '\0') {
+        case 'm': switch(len > 3 ? key[3] : '\0') {
+          case 'f': if(len == 12 && memcmp(key + 4, "d_create", 8) == 0) { return 319; } break;
+          case 'b': if(len == 10 && memcmp(key + 4, "arrier", 6) == 0) { return 324; } break;
+        } break;
+      } break;
+    } break;
+    case 'b': switch(len > 1 ? key[1] : '\0') {
+      case 'r': if(len == 3 && key[2] == 'k') { return 12; } break;
+      case 'i': if(len == 4 && memcmp(key + 2, "nd", 2) == 0) { return 49; } break;
+      case 'p': if(len == 3 && key[2] == 'f') { return 321; } break;
+    } break;
+    case 'i': switch(len > 1 ? key[1] : '\0') {
+      case 'o': switch(len > 2 ? key[2] : '\0') {
+        case 'c': if(len == 5 && memcmp(key + 3, "tl", 2) == 0) { return 16; } break;
+        case 'p': switch(len > 3 ? key[3] : '\0') {
+          case 'l': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 172;
+          } break;
+          case 'e': if(len == 6 && memcmp(key + 4, "rm", 2) == 0) { return 173; } break;
+          case 'r': switch(len > 4 ? key[4] : '\0') {
+            case 'i': switch(len > 5 ? key[5] : '\0') {
+              case 'o': switch(len > 6 ? key[6] : '\0') {
+                case '_': switch(len > 7 ? key[7] : '\0') {
+                  case 's': if(len == 10 && memcmp(key + 8, "et", 2) == 0) { return 251; } break;
+                  case 'g': if(len == 10 && memcmp(key + 8, "et", 2) == 0) { return 252; } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case '_': switch(len > 3 ? key[3] : '\0') {
+          case 's': switch(len > 4 ? key[4] : '\0') {
+            case 'e': if(len == 8 && memcmp(key + 5, "tup", 3) == 0) { return 206; } break;
+            case 'u': if(len == 9 && memcmp(key + 5, "bmit", 4) == 0) { return 209; } break;
+          } break;
+          case 'd': if(len == 10 && memcmp(key + 4, "estroy", 6) == 0) { return 207; } break;
+          case 'g': if(len == 12 && memcmp(key + 4, "etevents", 8) == 0) { return 208; } break;
+          case 'c': if(len == 9 && memcmp(key + 4, "ancel", 5) == 0) { return 210; } break;
+        } break;
+      } break;
+      case 'n': switch(len > 2 ? key[2] : '\0') {
+        case 'i': if(len == 11 && memcmp(key + 3, "t_module", 8) == 0) { return 175; } break;
+        case 'o': switch(len > 3 ? key[3] : '\0') {
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case 'i': switch(len > 5 ? key[5] : '\0') {
+              case 'f': switch(len > 6 ? key[6] : '\0') {
+                case 'y': switch(len > 7 ? key[7] : '\0') {
+                  case '_': switch(len > 8 ? key[8] : '\0') {
+                    case 'i': switch(len > 9 ? key[9] : '\0') {
+                      case 'n': switch(len > 10 ? key[10] : '\0') {
+                        case 'i': switch(len > 11 ? key[11] : '\0') {
+                          case 't': switch(len > 12 ? key[12] : '\0') {
+                            case '\x00': return 253;
+                            case '1': switch(len > 13 ? key[13] : '\0') {
+                              case '\x00': return 294;
+                            } break;
+                          } break;
+                        } break;
+                      } break;
+                    } break;
+                    case 'a': if(len == 17 && memcmp(key + 9, "dd_watch", 8) == 0) { return 254; } break;
+                    case 'r': if(len == 16 && memcmp(key + 9, "m_watch", 7) == 0) { return 255; } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+    } break;
+    case 'a': switch(len > 1 ? key[1] : '\0') {
+      case 'c': switch(len > 2 ? key[2] : '\0') {
+        case 'c': switch(len > 3 ? key[3] : '\0') {
+          case 'e': switch(len > 4 ? key[4] : '\0') {
+            case 's': if(len == 6 && key[5] == 's') { return 21; } break;
+            case 'p': switch(len > 5 ? key[5] : '\0') {
+              case 't': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 43;
+                case '4': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return 288;
+                } break;
+              } break;
+            } break;
+          } break;
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 163;
+          } break;
+        } break;
+      } break;
+      case 'l': if(len == 5 && memcmp(key + 2, "arm", 3) == 0) { return 37; } break;
+      case 'r': if(len == 10 && memcmp(key + 2, "ch_prctl", 8) == 0) { return 158; } break;
+      case 'd': switch(len > 2 ? key[2] : '\0') {
+        case 'j': if(len == 8 && memcmp(key + 3, "timex", 5) == 0) { return 159; } break;
+        case 'd': if(len == 7 && memcmp(key + 3, "_key", 4) == 0) { return 248; } break;
+      } break;
+      case 'f': if(len == 11 && memcmp(key + 2, "s_syscall", 9) == 0) { return 183; } break;
+    } break;
+    case 'd': switch(len > 1 ? key[1] : '\0') {
+      case 'u': switch(len > 2 ? key[2] : '\0') {
+        case 'p': switch(len > 3 ? key[3] : '\0') {
+          case '\x00': return 32;
+          case '2': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 33;
+          } break;
+          case '3': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 292;
+          } break;
+        } break;
+      } break;
+      case 'e': if(len == 13 && memcmp(key + 2, "lete_module", 11) == 0) { return 176; } break;
+    } break;
+    case 'n': switch(len > 1 ? key[1] : '\0') {
+      case 'a': switch(len > 2 ? key[2] : '\0') {
+        case 'n': if(len == 9 && memcmp(key + 3, "osleep", 6) == 0) { return 35; } break;
+        case 'm': if(len == 17 && memcmp(key + 3, "e_to_handle_at", 14) == 0) { return 303; } break;
+      } break;
+      case 'f': if(len == 10 && memcmp(key + 2, "sservctl", 8) == 0) { return 180; } break;
+      case 'e': if(len == 10 && memcmp(key + 2, "wfstatat", 8) == 0) { return 262; } break;
+    } break;
+    case 'g': switch(len > 1 ? key[1] : '\0') {
+      case 'e': switch(len > 2 ? key[2] : '\0') {
+        case 't': switch(len > 3 ? key[3] : '\0') {
+          case 'i': if(len == 9 && memcmp(key + 4, "timer", 5) == 0) { return 36; } break;
+          case 'p': switch(len > 4 ? key[4] : '\0') {
+            case 'i': if(len == 6 && key[5] == 'd') { return 39; } break;
+            case 'e': if(len == 11 && memcmp(key + 5, "ername", 6) == 0) { return 52; } break;
+            case 'p': if(len == 7 && memcmp(key + 5, "id", 2) == 0) { return 110; } break;
+            case 'g': switch(len > 5 ? key[5] : '\0') {
+              case 'r': if(len == 7 && key[6] == 'p') { return 111; } break;
+              case 'i': if(len == 7 && key[6] == 'd') { return 121; } break;
+            } break;
+            case 'r': if(len == 11 && memcmp(key + 5, "iority", 6) == 0) { return 140; } break;
+            case 'm': if(len == 7 && memcmp(key + 5, "sg", 2) == 0) { return 181; } break;
+          } break;
+          case 's': switch(len > 4 ? key[4] : '\0') {
+            case 'o': switch(len > 5 ? key[5] : '\0') {
+              case 'c': switch(len > 6 ? key[6] : '\0') {
+                case 'k': switch(len > 7 ? key[7] : '\0') {
+                  case 'n': if(len == 11 && memcmp(key + 8, "ame", 3) == 0) { return 51; } break;
+                  case 'o': if(len == 10 && memcmp(key + 8, "pt", 2) == 0) { return 55; } break;
+                } break;
+              } break;
+            } break;
+            case 'i': if(len == 6 && key[5] == 'd') { return 124; } break;
+          } break;
+          case 'd': switch(len > 4 ? key[4] : '\0') {
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case 'n': switch(len > 6 ? key[6] : '\0') {
+                case 't': switch(len > 7 ? key[7] : '\0') {
+                  case 's': switch(len > 8 ? key[8] : '\0') {
+                    case '\x00': return 78;
+                    case '6': if(len == 10 && key[9] == '4') { return 217; } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+          case 'c': switch(len > 4 ? key[4] : '\0') {
+            case 'w': if(len == 6 && key[5] == 'd') { return 79; } break;
+            case 'p': if(len == 6 && key[5] == 'u') { return 309; } break;
+          } break;
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case 'i': switch(len > 5 ? key[5] : '\0') {
+              case 'm': if(len == 12 && memcmp(key + 6, "eofday", 6) == 0) { return 96; } break;
+              case 'd': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 186;
+              } break;
+            } break;
+          } break;
+          case 'r': switch(len > 4 ? key[4] : '\0') {
+            case 'l': if(len == 9 && memcmp(key + 5, "imit", 4) == 0) { return 97; } break;
+            case 'u': if(len == 9 && memcmp(key + 5, "sage", 4) == 0) { return 98; } break;
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case 's': switch(len > 6 ? key[6] : '\0') {
+                case 'u': if(len == 9 && memcmp(key + 7, "id", 2) == 0) { return 118; } break;
+                case 'g': if(len == 9 && memcmp(key + 7, "id", 2) == 0) { return 120; } break;
+              } break;
+            } break;
+            case 'a': if(len == 9 && memcmp(key + 5, "ndom", 4) == 0) { return 318; } break;
+          } break;
+          case 'u': if(len == 6 && memcmp(key + 4, "id", 2) == 0) { return 102; } break;
+          case 'g': switch(len > 4 ? key[4] : '\0') {
+            case 'i': if(len == 6 && key[5] == 'd') { return 104; } break;
+            case 'r': if(len == 9 && memcmp(key + 5, "oups", 4) == 0) { return 115; } break;
+          } break;
+          case 'e': switch(len > 4 ? key[4] : '\0') {
+            case 'u': if(len == 7 && memcmp(key + 5, "id", 2) == 0) { return 107; } break;
+            case 'g': if(len == 7 && memcmp(key + 5, "id", 2) == 0) { return 108; } break;
+          } break;
+          case '_': switch(len > 4 ? key[4] : '\0') {
+            case 'k': if(len == 15 && memcmp(key + 5, "ernel_syms", 10) == 0) { return 177; } break;
+            case 't': if(len == 15 && memcmp(key + 5, "hread_area", 10) == 0) { return 211; } break;
+            case 'm': if(len == 13 && memcmp(key + 5, "empolicy", 8) == 0) { return 239; } break;
+            case 'r': if(len == 15 && memcmp(key + 5, "obust_list", 10) == 0) { return 274; } break;
+          } break;
+          case 'x': if(len == 8 && memcmp(key + 4, "attr", 4) == 0) { return 191; } break;
+        } break;
+      } break;
+    } break;
+    case 'v': switch(len > 1 ? key[1] : '\0') {
+      case 'f': if(len == 5 && memcmp(key + 2, "ork", 3) == 0) { return 58; } break;
+      case 'h': if(len == 7 && memcmp(key + 2, "angup", 5) == 0) { return 153; } break;
+      case 's': if(len == 7 && memcmp(key + 2, "erver", 5) == 0) { return 236; } break;
+      case 'm': if(len == 8 && memcmp(key + 2, "splice", 6) == 0) { return 278; } break;
+    } break;
+    case 'e': switch(len > 1 ? key[1] : '\0') {
+      case 'x': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'c': switch(len > 4 ? key[4] : '\0') {
+            case 'v': switch(len > 5 ? key[5] : '\0') {
+              case 'e': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 59;
+                case 'a': if(len == 8 && key[7] == 't') { return 322; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case 'i': switch(len > 3 ? key[3] : '\0') {
+          case 't': switch(len > 4 ? key[4] : '\0') {
+            case '\x00': return 60;
+            case '_': if(len == 10 && memcmp(key + 5, "group", 5) == 0) { return 231; } break;
+          } break;
+        } break;
+      } break;
+      case 'p': switch(len > 2 ? key[2] : '\0') {
+        case 'o': switch(len > 3 ? key[3] : '\0') {
+          case 'l': switch(len > 4 ? key[4] : '\0') {
+            case 'l': switch(len > 5 ? key[5] : '\0') {
+              case '_': switch(len > 6 ? key[6] : '\0') {
+                case 'c': switch(len > 7 ? key[7] : '\0') {
+                  case 'r': switch(len > 8 ? key[8] : '\0') {
+                    case 'e': switch(len > 9 ? key[9] : '\0') {
+                      case 'a': switch(len > 10 ? key[10] : '\0') {
+                        case 't': switch(len > 11 ? key[11] : '\0') {
+                          case 'e': switch(len > 12 ? key[12] : '\0') {
+                            case '\x00': return 213;
+                            case '1': switch(len > 13 ? key[13] : '\0') {
+                              case '\x00': return 291;
+                            } break;
+                          } break;
+                        } break;
+                      } break;
+                    } break;
+                  } break;
+                  case 't': switch(len > 8 ? key[8] : '\0') {
+                    case 'l': switch(len > 9 ? key[9] : '\0') {
+                      case '_': if(len == 13 && memcmp(key + 10, "old", 3) == 0) { return 214; } break;
+                      case '\x00': return 233;
+                    } break;
+                  } break;
+                } break;
+                case 'w': switch(len > 7 ? key[7] : '\0') {
+                  case 'a': switch(len > 8 ? key[8] : '\0') {
+                    case 'i': switch(len > 9 ? key[9] : '\0') {
+                      case 't': switch(len > 10 ? key[10] : '\0') {
+                        case '_': if(len == 14 && memcmp(key + 11, "old", 3) == 0) { return 215; } break;
+                        case '\x00': return 232;
+                      } break;
+                    } break;
+                  } break;
+                } break;
+                case 'p': if(len == 11 && memcmp(key + 7, "wait", 4) == 0) { return 281; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'v': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'n': switch(len > 4 ? key[4] : '\0') {
+            case 't': switch(len > 5 ? key[5] : '\0') {
+              case 'f': switch(len > 6 ? key[6] : '\0') {
+                case 'd': switch(len > 7 ? key[7] : '\0') {
+                  case '\x00': return 284;
+                  case '2': switch(len > 8 ? key[8] : '\0') {
+                    case '\x00': return 290;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+    } break;
+    case 'k': switch(len > 1 ? key[1] : '\0') {
+      case 'i': if(len == 4 && memcmp(key + 2, "ll", 2) == 0) { return 62; } break;
+      case 'e': switch(len > 2 ? key[2] : '\0') {
+        case 'x': switch(len > 3 ? key[3] : '\0') {
+          case 'e': switch(len > 4 ? key[4] : '\0') {
+            case 'c': switch(len > 5 ? key[5] : '\0') {
+              case '_': switch(len > 6 ? key[6] : '\0') {
+                case 'l': if(len == 10 && memcmp(key + 7, "oad", 3) == 0) { return 246; } break;
+                case 'f': if(len == 15 && memcmp(key + 7, "ile_load", 8) == 0) { return 320; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case 'y': if(len == 6 && memcmp(key + 3, "ctl", 3) == 0) { return 250; } break;
+      } break;
+      case 'c': if(len == 4 && memcmp(key + 2, "mp", 2) == 0) { return 312; } break;
+    } break;
+    case 'u': switch(len > 1 ? key[1] : '\0') {
+      case 'n': switch(len > 2 ? key[2] : '\0') {
+        case 'a': if(len == 5 && memcmp(key + 3, "me", 2) == 0) { return 63; } break;
+        case 'l': switch(len > 3 ? key[3] : '\0') {
+          case 'i': switch(len > 4 ? key[4] : '\0') {
+            case 'n': switch(len > 5 ? key[5] : '\0') {
+              case 'k': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 87;
+                case 'a': if(len == 8 && key[7] == 't') { return 263; } break;
+              } break;
+            } break;
+          } break;
+        } break;
+        case 's': if(len == 7 && memcmp(key + 3, "hare", 4) == 0) { return 272; } break;
+      } break;
+      case 'm': switch(len > 2 ? key[2] : '\0') {
+        case 'a': if(len == 5 && memcmp(key + 3, "sk", 2) == 0) { return 95; } break;
+        case 'o': if(len == 7 && memcmp(key + 3, "unt2", 4) == 0) { return 166; } break;
+      } break;
+      case 't': switch(len > 2 ? key[2] : '\0') {
+        case 'i': switch(len > 3 ? key[3] : '\0') {
+          case 'm': switch(len > 4 ? key[4] : '\0') {
+            case 'e': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 132;
+              case 's': switch(len > 6 ? key[6] : '\0') {
+                case '\x00': return 235;
+              } break;
+              case 'n': if(len == 9 && memcmp(key + 6, "sat", 3) == 0) { return 280; } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 's': switch(len > 2 ? key[2] : '\0') {
+        case 'e': switch(len > 3 ? key[3] : '\0') {
+          case 'l': if(len == 6 && memcmp(key + 4, "ib", 2) == 0) { return 134; } break;
+          case 'r': if(len == 11 && memcmp(key + 4, "faultfd", 7) == 0) { return 323; } break;
+        } break;
+        case 't': if(len == 5 && memcmp(key + 3, "at", 2) == 0) { return 136; } break;
+      } break;
+    } break;
+    case 't': switch(len > 1 ? key[1] : '\0') {
+      case 'r': if(len == 8 && memcmp(key + 2, "uncate", 6) == 0) { return 76; } break;
+      case 'i': switch(len > 2 ? key[2] : '\0') {
+        case 'm': switch(len > 3 ? key[3] : '\0') {
+          case 'e': switch(len > 4 ? key[4] : '\0') {
+            case 's': switch(len > 5 ? key[5] : '\0') {
+              case '\x00': return 100;
+            } break;
+            case '\x00': return 201;
+            case 'r': switch(len > 5 ? key[5] : '\0') {
+              case '_': switch(len > 6 ? key[6] : '\0') {
+                case 'c': if(len == 12 && memcmp(key + 7, "reate", 5) == 0) { return 222; } break;
+                case 's': if(len == 13 && memcmp(key + 7, "ettime", 6) == 0) { return 223; } break;
+                case 'g': switch(len > 7 ? key[7] : '\0') {
+                  case 'e': switch(len > 8 ? key[8] : '\0') {
+                    case 't': switch(len > 9 ? key[9] : '\0') {
+                      case 't': if(len == 13 && memcmp(key + 10, "ime", 3) == 0) { return 224; } break;
+                      case 'o': if(len == 16 && memcmp(key + 10, "verrun", 6) == 0) { return 225; } break;
+                    } break;
+                  } break;
+                } break;
+                case 'd': if(len == 12 && memcmp(key + 7, "elete", 5) == 0) { return 226; } break;
+              } break;
+              case 'f': switch(len > 6 ? key[6] : '\0') {
+                case 'd': switch(len > 7 ? key[7] : '\0') {
+                  case '_': switch(len > 8 ? key[8] : '\0') {
+                    case 'c': if(len == 14 && memcmp(key + 9, "reate", 5) == 0) { return 283; } break;
+                    case 's': if(len == 15 && memcmp(key + 9, "ettime", 6) == 0) { return 286; } break;
+                    case 'g': if(len == 15 && memcmp(key + 9, "ettime", 6) == 0) { return 287; } break;
+                  } break;
+                } break;
+              } break;
+            } break;
+          } break;
+        } break;
+      } break;
+      case 'u': if(len == 7 && memcmp(key + 2, "xcall", 5) == 0) { return 184; } break;
+      case 'k': if(len == 5 && memcmp(key + 2, "ill", 3) == 0) { return 200; } break;
+      case 'g': if(len == 6 && memcmp(key + 2, "kill", 4) == 0) { return 234; } break;
+      case 'e': if(len == 3 && key[2] == 'e') { return 276; } break;
+    } break;
+    case '_': if(len == 7 && memcmp(key + 1, "sysctl", 6) == 0) { return 156; } break;
+    case 'q': switch(len > 1 ? key[1] : '\0') {
+      case 'u': switch(len > 2 ? key[2] : '\0') {
+        case 'e': if(len == 12 && memcmp(key + 3, "ry_module", 9) == 0) { return 178; } break;
+        case 'o': if(len == 8 && memcmp(key + 3, "tactl", 5) == 0) { return 179; } break;
+      } break;
+    } break;
+  }
+  return -1;
+}
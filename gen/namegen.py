@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+
+# Python script to generate the id -> name tables in C, the reverse of
+# the trie built by triegen.py from the same files, and the argument
+# counts each syscall takes. The third column of the syscall table is
+# the count, or min-max for syscalls whose trailing arguments may be left
+# out.
+
+import sys
+import re
+
+if len(sys.argv) != 4:
+    print("Wrong number of arguments. Usage: namegen.py <commands> <syscalls> <output>")
+    sys.exit(1)
+
+def read(path):
+    with open(path, 'r') as f:
+        return [re.split(r'\s+', l.strip()) for l in f.read().split('\n') if len(l.strip()) > 0]
+
+commands = read(sys.argv[1])
+
+names = {}
+args = {}
+for line in read(sys.argv[2]):
+    names[int(line[1])] = line[0]
+    counts = line[2].split('-')
+    args[int(line[1])] = (int(counts[0]), int(counts[-1]))
+
+count = max(names.keys()) + 1
+
+with open(sys.argv[3], 'w') as f:
+    f.write("#include <stddef.h>\n")
+    f.write("#include \"names.h\"\n")
+    f.write("#include \"trie.h\"\n\n")
+    f.write("/* auto-generated by namegen.py */\n\n")
+    f.write("const char* const syscall_names[SYSCALL_COUNT] = {\n")
+    for i in range(count):
+        if i in names:
+            f.write("  \"%s\",\n" % names[i])
+        else:
+            f.write("  NULL,\n")
+    f.write("};\n")
+    f.write("\nconst unsigned char syscall_min_args[SYSCALL_COUNT] = {")
+    for i in range(count):
+        f.write("%s%d," % ("\n  " if i % 16 == 0 else " ", args.get(i, (0, 6))[0]))
+    f.write("\n};\n")
+    f.write("\nconst unsigned char syscall_args[SYSCALL_COUNT] = {")
+    for i in range(count):
+        f.write("%s%d," % ("\n  " if i % 16 == 0 else " ", args.get(i, (0, 6))[1]))
+    f.write("\n};\n")
+    f.write("\n_Static_assert(%d == SYSCALL_COUNT, \"SYSCALL_COUNT out of date\");\n\n" % count)
+    f.write("const char* name_of(long id) {\n")
+    f.write("  if(id >= 0) return id < SYSCALL_COUNT ? syscall_names[id] : NULL;\n")
+    f.write("  switch(id) {\n")
+    for line in commands:
+        f.write("    case %s: return \"%s\";\n" % (line[1], line[0]))
+    f.write("    default: return NULL;\n")
+    f.write("  }\n")
+    f.write("}\n")
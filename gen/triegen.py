@@ -1,18 +1,31 @@
 #!/usr/bin/env python
 
-# Python script to generate a trie using switch statements in C
+# Python script to generate a trie using switch statements in C, or with
+# --phf a minimal perfect hash over the same names. Both backends define
+# trie_get, so the rest of the interpreter does not care which is built.
+# --name renames the function, which lets the benchmarks link both.
 
 import sys
 import re
 
-if len(sys.argv) < 3:
-    print("Not enough arguments. Usage: triegen.py <input> <output>")
+args = sys.argv[1:]
+phf = '--phf' in args
+if phf:
+    args.remove('--phf')
+func = 'trie_get'
+if '--name' in args:
+    i = args.index('--name')
+    func = args[i + 1]
+    del args[i:i + 2]
+
+if len(args) < 2:
+    print("Not enough arguments. Usage: triegen.py [--phf] [--name func] <input>... <output>")
     sys.exit(1)
 
-output_file = sys.argv[len(sys.argv) - 1]
+output_file = args[-1]
 
 data = []
-for input_file in sys.argv[1:-1]:
+for input_file in args[:-1]:
     with open(input_file, 'r') as f:
         data += [re.split('\s+', l.strip()) for l in f.read().split('\n') if len(l.strip()) > 0]
 
@@ -46,13 +59,14 @@ def matches_exact(trie, start):
 
 def write_trie(f, trie, depth):
     if line := matches_exact(trie, True):
+        end = depth + len(line[0])
         if len(line[0]) == 1:
-            f.write('if(key[%s] == \'%s\') { return %s; } break;\n' % (depth, line[0], line[1]))
+            f.write('if(len == %s && key[%s] == \'%s\') { return %s; } break;\n' % (end, depth, line[0], line[1]))
         else:
-            f.write('if(strcmp(key + %s, "%s") == 0) { return %s; } break;\n' % (depth, line[0], line[1]))
+            f.write('if(len == %s && memcmp(key + %s, "%s", %s) == 0) { return %s; } break;\n' % (end, depth, line[0], len(line[0]), line[1]))
         return
     ws = "  " * (depth + 2)
-    f.write("switch(key[%s]) {\n" % (depth))
+    f.write("switch(len > %s ? key[%s] : '\\0') {\n" % (depth, depth))
     for k, v in trie.items():
         f.write("%scase %s: " % (ws, repr(k)))
         if k == '\0':
@@ -64,12 +78,103 @@ def write_trie(f, trie, depth):
         f.write(" break;")
     f.write("\n")
 
-with open(output_file, 'w') as f:
+# The perfect hash takes one 64-bit hash of the key, mixed a word at a time.
+# The high half picks a bucket, and the bucket's displacement scrambles the
+# low half into a slot. Displacements are found largest bucket first, so
+# every key gets its own slot and the table has no holes.
+
+MASK32 = 0xffffffff
+MASK64 = 0xffffffffffffffff
+
+def phf_hash(key):
+    key = key.encode()
+    h = (len(key) * 0x9e3779b97f4a7c15) & MASK64
+    for i in range(0, len(key), 8):
+        w = int.from_bytes(key[i:i + 8], 'little')
+        h = ((h ^ w) * 0xff51afd7ed558ccd) & MASK64
+        h ^= h >> 32
+    return h
+
+def phf_slot(h, d, n):
+    return (((h & MASK32) ^ ((d * 0x9e3779b1) & MASK32)) * n) >> 32
+
+def build_phf(keys):
+    n = len(keys)
+    nbuckets = 1
+    while nbuckets * 2 < n:
+        nbuckets *= 2
+    buckets = [[] for _ in range(nbuckets)]
+    for k in keys:
+        h = phf_hash(k)
+        buckets[(h >> 32) & (nbuckets - 1)].append(h)
+    disp = [0] * nbuckets
+    taken = [False] * n
+    for b in sorted(range(nbuckets), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for d in range(1 << 16):
+            slots = [phf_slot(h, d, n) for h in buckets[b]]
+            if len(set(slots)) == len(slots) and not any(taken[s] for s in slots):
+                break
+        else:
+            print("triegen.py: no perfect hash displacement found")
+            sys.exit(1)
+        disp[b] = d
+        for s in slots:
+            taken[s] = True
+    table = [None] * n
+    for k in keys:
+        h = phf_hash(k)
+        table[phf_slot(h, disp[(h >> 32) & (nbuckets - 1)], n)] = k
+    return disp, table
+
+def write_phf(f, data):
+    values = {line[0]: line[1] for line in data}
+    disp, table = build_phf(list(values))
+    f.write("#include <stdint.h>\n")
     f.write("#include <string.h>\n")
     f.write("#include \"trie.h\"\n\n")
-    f.write("/* auto-generated by triegen.py */\n\n")
-    f.write("long trie_get(const char* key) {\n  ")
-    write_trie(f, trie, 0)
-    f.write("  return -1;\n}\n")
+    f.write("/* auto-generated by triegen.py --phf */\n\n")
+    f.write("#define PHF_KEYS %d\n" % len(table))
+    f.write("#define PHF_BUCKETS %d\n\n" % len(disp))
+    f.write("static const uint16_t phf_disp[PHF_BUCKETS] = {\n")
+    for i in range(0, len(disp), 12):
+        f.write("  %s,\n" % ", ".join(str(d) for d in disp[i:i + 12]))
+    f.write("};\n\n")
+    f.write("static const struct { const char* name; uint8_t len; long value; } phf_table[PHF_KEYS] = {\n")
+    for k in table:
+        f.write("  {\"%s\", %d, %s},\n" % (k, len(k), values[k]))
+    f.write("};\n\n")
+    f.write("long %s(const char* key, size_t len) {\n" % func)
+    f.write("  uint64_t h = len * 0x9e3779b97f4a7c15u;\n")
+    f.write("  size_t i = 0;\n")
+    f.write("  uint64_t w;\n")
+    f.write("  for(; i + 8 <= len; i += 8) {\n")
+    f.write("    memcpy(&w, key + i, 8);\n")
+    f.write("    h = (h ^ w) * 0xff51afd7ed558ccdu;\n")
+    f.write("    h ^= h >> 32;\n")
+    f.write("  }\n")
+    f.write("  if(i < len) {\n")
+    f.write("    w = 0;\n")
+    f.write("    for(size_t j = i; j < len; j++) w |= (uint64_t)(unsigned char)key[j] << (8 * (j - i));\n")
+    f.write("    h = (h ^ w) * 0xff51afd7ed558ccdu;\n")
+    f.write("    h ^= h >> 32;\n")
+    f.write("  }\n")
+    f.write("  uint32_t d = phf_disp[(h >> 32) & (PHF_BUCKETS - 1)];\n")
+    f.write("  uint32_t slot = ((uint64_t)((uint32_t)h ^ (d * 0x9e3779b1u)) * PHF_KEYS) >> 32;\n")
+    f.write("  if(phf_table[slot].len != len || memcmp(phf_table[slot].name, key, len) != 0) return -1;\n")
+    f.write("  return phf_table[slot].value;\n")
+    f.write("}\n")
+
+with open(output_file, 'w') as f:
+    if phf:
+        write_phf(f, data)
+    else:
+        f.write("#include <string.h>\n")
+        f.write("#include \"trie.h\"\n\n")
+        f.write("/* auto-generated by triegen.py */\n\n")
+        f.write("long %s(const char* key, size_t len) {\n  " % func)
+        write_trie(f, trie, 0)
+        f.write("  return -1;\n}\n")
             
 
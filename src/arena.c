@@ -0,0 +1,67 @@
+#define _GNU_SOURCE
+#include <sys/mman.h>
+
+#include "arena.h"
+
+#define ARENA_MIN (64 * 1024)
+#define ARENA_ALIGN 8
+
+void arena_init(Arena* arena) {
+    arena->base = NULL;
+    arena->len = 0;
+    arena->capacity = 0;
+    arena->sealed = false;
+}
+
+void arena_free(Arena* arena) {
+    if(arena->base != NULL) munmap(arena->base, arena->capacity);
+    arena_init(arena);
+}
+
+// Keeps the mapping so the REPL can reuse it for every line.
+void arena_reset(Arena* arena) {
+    if(arena->sealed) mprotect(arena->base, arena->capacity, PROT_READ | PROT_WRITE);
+    arena->len = 0;
+    arena->sealed = false;
+}
+
+void arena_seal(Arena* arena) {
+    if(arena->base != NULL) mprotect(arena->base, arena->capacity, PROT_READ);
+    arena->sealed = true;
+}
+
+bool arena_map(Arena* arena, int fd, size_t offset, size_t len) {
+    arena_init(arena);
+    if(len == 0) {
+        arena->sealed = true;
+        return true;
+    }
+    void* base = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, offset);
+    if(base == MAP_FAILED) return false;
+    arena->base = base;
+    arena->len = len;
+    arena->capacity = len;
+    arena->sealed = true;
+    return true;
+}
+
+uint32_t arena_alloc(Arena* arena, size_t size) {
+    if(arena->sealed) return ARENA_FAILED;
+    size_t offset = (arena->len + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if(offset + size >= ARENA_FAILED) return ARENA_FAILED;
+    if(offset + size > arena->capacity) {
+        size_t capacity = (arena->capacity == 0 ? ARENA_MIN : arena->capacity);
+        while(capacity < offset + size) capacity *= 2;
+        void* base;
+        if(arena->base == NULL) {
+            base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        } else {
+            base = mremap(arena->base, arena->capacity, capacity, MREMAP_MAYMOVE);
+        }
+        if(base == MAP_FAILED) return ARENA_FAILED;
+        arena->base = base;
+        arena->capacity = capacity;
+    }
+    arena->len = offset + size;
+    return offset;
+}
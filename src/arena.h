@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump arena backing a parsed script: the tree and its string literals
+// live in one mapping and refer to each other by offset, so the mapping
+// may move while it grows. Once parsing is done the arena is sealed
+// read-only, which keeps string literals immutable while scripts hold
+// pointers to them.
+typedef struct {
+    char* base;
+    size_t len;
+    size_t capacity;
+    bool sealed;
+} Arena;
+
+#define ARENA_FAILED UINT32_MAX
+
+void arena_init(Arena* arena);
+void arena_free(Arena* arena);
+void arena_reset(Arena* arena);
+void arena_seal(Arena* arena);
+// Maps len bytes of fd from offset, which must be page aligned, as a
+// sealed arena. Returns false if the mapping fails.
+bool arena_map(Arena* arena, int fd, size_t offset, size_t len);
+
+// Returns the offset of size fresh bytes, aligned for any field type.
+uint32_t arena_alloc(Arena* arena, size_t size);
+
+static inline void* arena_at(const Arena* arena, uint32_t offset) {
+    return arena->base + offset;
+}
@@ -0,0 +1,302 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "batch.h"
+#include "coalesce.h"
+#include "sys.h"
+
+#define RING_ENTRIES 128
+
+bool batch_uring = true;
+
+// Each thread sets up its own ring on first use and keeps it for the
+// life of the process, so tasks can batch without sharing queues.
+static _Thread_local struct {
+    bool tried;
+    bool ok;
+    int fd;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    unsigned features;
+    bool supported[IORING_OP_LAST];
+} ring;
+
+static void probe_ops(void) {
+    char buf[sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op)];
+    memset(buf, 0, sizeof(buf));
+    struct io_uring_probe* probe = (struct io_uring_probe*)buf;
+    if(syscall(SYS_io_uring_register, ring.fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) {
+        return;
+    }
+    for(int i = 0; i < probe->ops_len && i < IORING_OP_LAST; i++) {
+        ring.supported[i] = probe->ops[i].flags & IO_URING_OP_SUPPORTED;
+    }
+}
+
+static bool ring_setup(void) {
+    if(ring.tried) return ring.ok;
+    ring.tried = true;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(SYS_io_uring_setup, RING_ENTRIES, &params);
+    if(fd < 0) return false;
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if(single && cq_size > sq_size) sq_size = cq_size;
+
+    char* sq = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(sq == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    char* cq = sq;
+    if(!single) {
+        cq = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(cq == MAP_FAILED) {
+            munmap(sq, sq_size);
+            close(fd);
+            return false;
+        }
+    }
+    void* sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) {
+        munmap(sq, sq_size);
+        if(!single) munmap(cq, cq_size);
+        close(fd);
+        return false;
+    }
+
+    ring.fd = fd;
+    ring.sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring.sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring.sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring.sqes = sqes;
+    ring.cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring.cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring.cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    ring.features = params.features;
+    probe_ops();
+    ring.ok = true;
+    return true;
+}
+
+// Translates a syscall into an SQE. Returns false for calls io_uring
+// cannot express, which then run synchronously.
+static bool prep(struct io_uring_sqe* sqe, BatchOp* op) {
+    long* a = op->args;
+    bool cur_pos = ring.features & IORING_FEAT_RW_CUR_POS;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = a[0];
+    switch(op->id) {
+        case SYS_read:
+            if(!cur_pos) return false;
+            sqe->opcode = IORING_OP_READ;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = -1;
+            break;
+        case SYS_write:
+            if(!cur_pos) return false;
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = -1;
+            break;
+        case SYS_pread64:
+            sqe->opcode = IORING_OP_READ;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = a[3];
+            break;
+        case SYS_pwrite64:
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = a[3];
+            break;
+        case SYS_readv:
+            if(!cur_pos) return false;
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = -1;
+            break;
+        case SYS_writev:
+            if(!cur_pos) return false;
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = -1;
+            break;
+        case SYS_preadv:
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = a[3];
+            break;
+        case SYS_pwritev:
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->off = a[3];
+            break;
+        case SYS_close:
+            sqe->opcode = IORING_OP_CLOSE;
+            break;
+        case SYS_fsync:
+            sqe->opcode = IORING_OP_FSYNC;
+            break;
+        case SYS_fdatasync:
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+            break;
+        case SYS_open:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = a[0]; sqe->open_flags = a[1]; sqe->len = a[2];
+            break;
+        case SYS_openat:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->addr = a[1]; sqe->open_flags = a[2]; sqe->len = a[3];
+            break;
+        case SYS_statx:
+            sqe->opcode = IORING_OP_STATX;
+            sqe->addr = a[1]; sqe->statx_flags = a[2]; sqe->len = a[3]; sqe->off = a[4];
+            break;
+        case SYS_fallocate:
+            sqe->opcode = IORING_OP_FALLOCATE;
+            sqe->len = a[1]; sqe->off = a[2]; sqe->addr = a[3];
+            break;
+        case SYS_fadvise64:
+            sqe->opcode = IORING_OP_FADVISE;
+            sqe->off = a[1]; sqe->len = a[2]; sqe->fadvise_advice = a[3];
+            break;
+        case SYS_madvise:
+            sqe->opcode = IORING_OP_MADVISE;
+            sqe->fd = -1;
+            sqe->addr = a[0]; sqe->len = a[1]; sqe->fadvise_advice = a[2];
+            break;
+        case SYS_sendmsg:
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->addr = a[1]; sqe->msg_flags = a[2];
+            break;
+        case SYS_recvmsg:
+            sqe->opcode = IORING_OP_RECVMSG;
+            sqe->addr = a[1]; sqe->msg_flags = a[2];
+            break;
+        case SYS_sendto:
+            if(a[4] != 0) return false;
+            sqe->opcode = IORING_OP_SEND;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->msg_flags = a[3];
+            break;
+        case SYS_recvfrom:
+            if(a[4] != 0) return false;
+            sqe->opcode = IORING_OP_RECV;
+            sqe->addr = a[1]; sqe->len = a[2]; sqe->msg_flags = a[3];
+            break;
+        case SYS_accept:
+        case SYS_accept4:
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->addr = a[1]; sqe->addr2 = a[2];
+            sqe->accept_flags = (op->id == SYS_accept4) ? a[3] : 0;
+            break;
+        case SYS_connect:
+            sqe->opcode = IORING_OP_CONNECT;
+            sqe->addr = a[1]; sqe->off = a[2];
+            break;
+        case SYS_shutdown:
+            sqe->opcode = IORING_OP_SHUTDOWN;
+            sqe->len = a[1];
+            break;
+        case SYS_unlinkat:
+            sqe->opcode = IORING_OP_UNLINKAT;
+            sqe->addr = a[1]; sqe->unlink_flags = a[2];
+            break;
+        case SYS_mkdirat:
+            sqe->opcode = IORING_OP_MKDIRAT;
+            sqe->addr = a[1]; sqe->len = a[2];
+            break;
+        default:
+            return false;
+    }
+    return ring.supported[sqe->opcode];
+}
+
+static void run_sync(BatchOp* op) {
+    long result = sys_call(op->id, op->args);
+    op->err = sys_error(result);
+    op->result = (op->err != 0) ? -1 : result;
+}
+
+static void complete(BatchOp* op, int res) {
+    op->result = (res < 0) ? -1 : res;
+    op->err = (res < 0) ? -res : 0;
+}
+
+// Queues up to RING_ENTRIES ops and waits for all of them with a single
+// io_uring_enter. Returns how many ops were consumed.
+static int run_ring(BatchOp* ops, int len) {
+    unsigned tail = *ring.sq_tail;
+    unsigned mask = *ring.sq_mask;
+    int queued = 0;
+    int used = 0;
+    while(used < len && queued < RING_ENTRIES) {
+        BatchOp* op = &ops[used];
+        unsigned index = (tail + queued) & mask;
+        if(prep(&ring.sqes[index], op)) {
+            ring.sqes[index].user_data = used;
+            ring.sq_array[index] = index;
+            queued++;
+        } else {
+            run_sync(op);
+        }
+        used++;
+    }
+    if(queued == 0) return used;
+    __atomic_store_n(ring.sq_tail, tail + queued, __ATOMIC_RELEASE);
+
+    // Ring ops are traced with their latency from submission to completion.
+    long start = trace_enabled ? trace_clock() : 0;
+    int done = 0;
+    int submitted = syscall(SYS_io_uring_enter, ring.fd, queued, queued, IORING_ENTER_GETEVENTS, NULL, 0);
+    if(submitted < 0) submitted = 0;
+    while(done < submitted) {
+        unsigned head = *ring.cq_head;
+        unsigned cq_tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        if(head == cq_tail) {
+            syscall(SYS_io_uring_enter, ring.fd, 0, submitted - done, IORING_ENTER_GETEVENTS, NULL, 0);
+            continue;
+        }
+        for(; head != cq_tail; head++) {
+            struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+            BatchOp* op = &ops[cqe->user_data];
+            complete(op, cqe->res);
+            stats_bump(STAT_SYSCALLS);
+            if(trace_enabled) trace_record(op->id, trace_clock() - start, cqe->res < 0);
+            done++;
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+    // Anything the kernel refused to take is withdrawn and run directly.
+    if(submitted < queued) {
+        __atomic_store_n(ring.sq_tail, tail + submitted, __ATOMIC_RELEASE);
+        for(int i = submitted; i < queued; i++) {
+            run_sync(&ops[ring.sqes[(tail + i) & mask].user_data]);
+        }
+    }
+    return used;
+}
+
+void batch_run(BatchOp* ops, int len) {
+    // Ring ops bypass sys_call, which would write coalesced output first.
+    coalesce_flush();
+    if(!batch_uring || !ring_setup()) {
+        for(int i = 0; i < len; i++) run_sync(&ops[i]);
+        return;
+    }
+    int i = 0;
+    while(i < len) {
+        i += run_ring(&ops[i], len - i);
+    }
+}
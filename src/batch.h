@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+
+// One syscall collected by .batch. Arguments are evaluated before the
+// batch is submitted; result and err follow the syscall() convention.
+typedef struct {
+    long id;
+    long args[6];
+    long result;
+    int err;
+} BatchOp;
+
+// Batches of up to this many ops are collected on the stack, and larger
+// ones on the heap.
+#define BATCH_INLINE 32
+
+// Submits ops through io_uring where the kernel supports them and runs
+// the rest with plain syscalls. The ops must not depend on each other:
+// io_uring may complete them in any order.
+void batch_run(BatchOp* ops, int len);
+
+// Set to false to always run batches sequentially.
+extern bool batch_uring;
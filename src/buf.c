@@ -0,0 +1,179 @@
+#include <immintrin.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "buf.h"
+
+typedef struct {
+    long (*find_byte)(const unsigned char* p, long n, unsigned char c);
+    long (*find)(const unsigned char* p, long n, const unsigned char* needle, long k);
+    long (*count)(const unsigned char* p, long n, unsigned char c);
+    long (*mismatch)(const unsigned char* a, const unsigned char* b, long n);
+} Kernels;
+
+static long find_byte_sse2(const unsigned char* p, long n, unsigned char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    long i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if(mask != 0) return i + __builtin_ctz(mask);
+    }
+    for(; i < n; i++) {
+        if(p[i] == c) return i;
+    }
+    return -1;
+}
+
+// Candidates are positions where both the first and the last byte of the
+// needle match; only those are compared in full. k is at least 2.
+static long find_sse2(const unsigned char* p, long n, const unsigned char* needle, long k) {
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[k - 1]);
+    long i = 0;
+    for(; i + k - 1 + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(p + i + k - 1));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+        for(; mask != 0; mask &= mask - 1) {
+            long at = i + __builtin_ctz(mask);
+            if(memcmp(p + at + 1, needle + 1, k - 2) == 0) return at;
+        }
+    }
+    for(; i + k <= n; i++) {
+        if(p[i] == needle[0] && memcmp(p + i, needle, k) == 0) return i;
+    }
+    return -1;
+}
+
+// Matches are counted in byte lanes, which are summed into the total
+// before any of them can overflow.
+static long count_sse2(const unsigned char* p, long n, unsigned char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    long total = 0;
+    long i = 0;
+    while(i + 16 <= n) {
+        __m128i lanes = _mm_setzero_si128();
+        for(int r = 0; r < 255 && i + 16 <= n; r++, i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(v, needle));
+        }
+        __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+        total += _mm_cvtsi128_si64(sums) + _mm_extract_epi16(sums, 4);
+    }
+    for(; i < n; i++) total += p[i] == c;
+    return total;
+}
+
+static long mismatch_sse2(const unsigned char* a, const unsigned char* b, long n) {
+    long i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) ^ 0xffff;
+        if(mask != 0) return i + __builtin_ctz(mask);
+    }
+    while(i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+__attribute__((target("avx2")))
+static long find_byte_avx2(const unsigned char* p, long n, unsigned char c) {
+    __m256i needle = _mm256_set1_epi8(c);
+    long i = 0;
+    for(; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle));
+        if(mask != 0) return i + __builtin_ctz(mask);
+    }
+    long rest = find_byte_sse2(p + i, n - i, c);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2")))
+static long find_avx2(const unsigned char* p, long n, const unsigned char* needle, long k) {
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[k - 1]);
+    long i = 0;
+    for(; i + k - 1 + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p + i + k - 1));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+        for(; mask != 0; mask &= mask - 1) {
+            long at = i + __builtin_ctz(mask);
+            if(memcmp(p + at + 1, needle + 1, k - 2) == 0) return at;
+        }
+    }
+    long rest = find_sse2(p + i, n - i, needle, k);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2")))
+static long count_avx2(const unsigned char* p, long n, unsigned char c) {
+    __m256i needle = _mm256_set1_epi8(c);
+    long total = 0;
+    long i = 0;
+    while(i + 32 <= n) {
+        __m256i lanes = _mm256_setzero_si256();
+        for(int r = 0; r < 255 && i + 32 <= n; r++, i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+            lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(v, needle));
+        }
+        __m256i sums = _mm256_sad_epu8(lanes, _mm256_setzero_si256());
+        total += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1)
+               + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+    }
+    return total + count_sse2(p + i, n - i, c);
+}
+
+__attribute__((target("avx2")))
+static long mismatch_avx2(const unsigned char* a, const unsigned char* b, long n) {
+    long i = 0;
+    for(; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if(mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + mismatch_sse2(a + i, b + i, n - i);
+}
+
+static Kernels kernels = {find_byte_sse2, find_sse2, count_sse2, mismatch_sse2};
+
+void buf_init(void) {
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        kernels = (Kernels){find_byte_avx2, find_avx2, count_avx2, mismatch_avx2};
+    }
+}
+
+long buf_find_byte(const void* buf, long len, long byte) {
+    if(len <= 0) return -1;
+    return kernels.find_byte(buf, len, byte);
+}
+
+long buf_find(const void* buf, long len, const void* needle, long needle_len) {
+    if(needle_len <= 0) return 0;
+    if(len < needle_len) return -1;
+    if(needle_len == 1) return kernels.find_byte(buf, len, *(const unsigned char*)needle);
+    return kernels.find(buf, len, needle, needle_len);
+}
+
+long buf_count(const void* buf, long len, long byte) {
+    if(len <= 0) return 0;
+    return kernels.count(buf, len, byte);
+}
+
+long buf_cmp(const void* a, const void* b, long len) {
+    if(len <= 0) return 0;
+    long at = kernels.mismatch(a, b, len);
+    if(at == len) return 0;
+    return (long)((const unsigned char*)a)[at] - ((const unsigned char*)b)[at];
+}
+
+// glibc already picks the widest memset the CPU has, and uses
+// non-temporal stores for large sizes.
+long buf_fill(void* buf, long len, long byte) {
+    if(len > 0) memset(buf, (unsigned char)byte, len);
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Kernels behind the buffer builtins .find, .count, .cmp and .fill. They
+// scan 16 bytes at a time with SSE2, or 32 with AVX2 once buf_init has
+// found it, so searching a buffer runs at memory speed rather than one
+// interpreted line per byte. A negative len is treated as 0.
+
+// Picks the widest kernels the CPU supports. Until it is called the
+// SSE2 ones, which every x86-64 CPU has, are used.
+void buf_init(void);
+
+// Index of the first byte of buf equal to byte, or -1.
+long buf_find_byte(const void* buf, long len, long byte);
+
+// Index of the first occurrence of the needle_len bytes at needle, or -1.
+long buf_find(const void* buf, long len, const void* needle, long needle_len);
+
+// Number of bytes of buf equal to byte.
+long buf_count(const void* buf, long len, long byte);
+
+// Compares len bytes like memcmp, returning the difference between the
+// first pair of bytes that differ, or 0.
+long buf_cmp(const void* a, const void* b, long len);
+
+// Sets len bytes of buf to byte and returns 0.
+long buf_fill(void* buf, long len, long byte);
@@ -0,0 +1,227 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "mem.h"
+
+#define CACHE_MAGIC "SYSC"
+// Bump when the header changes. Changes to the tree or the command ids
+// are covered by the build stamp.
+#define CACHE_FORMAT 1
+
+// Every make rebuilds every file, so this differs between any two builds
+// that could disagree about what a tree means.
+static const char build[24] = __DATE__ " " __TIME__;
+
+// The image starts with this header and the source path, padded to a
+// page, followed by the arena.
+typedef struct {
+    char magic[4];
+    uint32_t format;
+    char build[24];
+    uint64_t hash;
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t ino;
+    uint64_t dev;
+    Block root;
+    uint32_t slots;
+    uint32_t path_len;
+    uint64_t arena_offset;
+    uint64_t arena_len;
+} Header;
+
+static uint64_t mix(uint64_t h, uint64_t w) {
+    h = (h ^ w) * 0x9e3779b97f4a7c15u;
+    return h ^ (h >> 29);
+}
+
+// Four independent lanes keep the multiplier busy, so hashing a large
+// script costs little more than reading it.
+static uint64_t hash_text(const char* text, size_t len) {
+    uint64_t lanes[4] = {len, 1, 2, 3};
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32) {
+        uint64_t w[4];
+        memcpy(w, text + i, sizeof(w));
+        for(int l = 0; l < 4; l++) lanes[l] = mix(lanes[l], w[l]);
+    }
+    uint64_t h = mix(mix(mix(lanes[0], lanes[1]), lanes[2]), lanes[3]);
+    for(; i < len; i += 8) {
+        uint64_t w = 0;
+        memcpy(&w, text + i, len - i < 8 ? len - i : 8);
+        h = mix(h, w);
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdu;
+    h ^= h >> 33;
+    return h;
+}
+
+static void stamp(Header* h, const struct stat* st) {
+    h->size = st->st_size;
+    h->mtime_sec = st->st_mtim.tv_sec;
+    h->mtime_nsec = st->st_mtim.tv_nsec;
+    h->ino = st->st_ino;
+    h->dev = st->st_dev;
+}
+
+static bool same_stamp(const Header* h, const struct stat* st) {
+    return h->size == (uint64_t)st->st_size && h->mtime_sec == st->st_mtim.tv_sec
+        && h->mtime_nsec == st->st_mtim.tv_nsec && h->ino == st->st_ino && h->dev == st->st_dev;
+}
+
+char* cache_path(const char* source) {
+    size_t len = strlen(source);
+    if(len > 5 && strcmp(source + len - 5, ".sysh") == 0) len -= 5;
+    char* path = mem_alloc(len + 6);
+    memcpy(path, source, len);
+    memcpy(path + len, ".sysc", 6);
+    return path;
+}
+
+// Reads and checks the header of an open image.
+static CacheStatus read_header(int fd, Header* h) {
+    if(pread(fd, h, sizeof(*h), 0) != sizeof(*h)) return CACHE_NONE;
+    if(memcmp(h->magic, CACHE_MAGIC, 4) != 0) return CACHE_NONE;
+    if(h->format != CACHE_FORMAT || memcmp(h->build, build, sizeof(build)) != 0) return CACHE_STALE;
+    return CACHE_OK;
+}
+
+// Checks a source whose stamp no longer matches by its contents, and
+// records the new stamp if they are unchanged.
+static bool same_contents(int image_fd, Header* h, const char* source, const struct stat* st) {
+    if(h->size != (uint64_t)st->st_size) return false;
+    if(st->st_size == 0) return h->hash == hash_text("", 0);
+    int fd = open(source, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return false;
+    const char* text = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(text == MAP_FAILED) return false;
+    bool same = hash_text(text, st->st_size) == h->hash;
+    munmap((void*)text, st->st_size);
+    if(same) {
+        // Only saves hashing next time, so failing to write is harmless.
+        stamp(h, st);
+        if(pwrite(image_fd, h, sizeof(*h), 0) < 0) errno = 0;
+    }
+    return same;
+}
+
+// Whether len items of size, starting at offset, lie inside the arena.
+static bool valid_run(const Arena* a, uint32_t offset, int len, size_t size) {
+    return len >= 0 && offset <= a->len && (size_t)len <= (a->len - offset) / size;
+}
+
+static CacheStatus load(const char* image, const char* source, Ast* ast, Cached* prog) {
+    int fd = open(image, O_RDWR | O_CLOEXEC);
+    if(fd < 0) fd = open(image, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return CACHE_NONE;
+    Header h;
+    CacheStatus status = read_header(fd, &h);
+    struct stat st;
+    if(status == CACHE_OK) {
+        if(stat(source, &st) < 0) {
+            status = CACHE_STALE;
+        } else if(!same_stamp(&h, &st) && !same_contents(fd, &h, source, &st)) {
+            status = CACHE_STALE;
+        }
+    }
+    // A truncated or damaged image is rebuilt like a stale one.
+    if(status == CACHE_OK && (fstat(fd, &st) < 0 || h.arena_len >= ARENA_FAILED || h.slots < 2
+                              || h.arena_len > (uint64_t)st.st_size
+                              || h.arena_offset > (uint64_t)st.st_size - h.arena_len
+                              || !arena_map(&ast->arena, fd, h.arena_offset, h.arena_len))) {
+        status = CACHE_STALE;
+    } else if(status == CACHE_OK && !valid_run(&ast->arena, h.root.lines, h.root.len, sizeof(Line))) {
+        arena_free(&ast->arena);
+        status = CACHE_STALE;
+    }
+    close(fd);
+    if(status == CACHE_OK) {
+        prog->root = h.root;
+        prog->slots = h.slots;
+    }
+    return status;
+}
+
+// Leaves errno as it was: failing to use an image is not an error.
+CacheStatus cache_load(const char* image, const char* source, Ast* ast, Cached* prog) {
+    int saved = errno;
+    CacheStatus status = load(image, source, ast, prog);
+    errno = saved;
+    return status;
+}
+
+char* cache_source(const char* image) {
+    int fd = open(image, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return NULL;
+    Header h;
+    char path[PATH_MAX];
+    CacheStatus status = read_header(fd, &h);
+    // A stale image still names its source, which is what rebuilding
+    // it needs. The path has been in the same place in every format.
+    bool named = status != CACHE_NONE && h.path_len < PATH_MAX
+        && pread(fd, path, h.path_len, sizeof(h)) == h.path_len;
+    close(fd);
+    if(!named) return NULL;
+    path[h.path_len] = '\0';
+    return mem_strdup(path);
+}
+
+static bool write_all(int fd, const void* buf, size_t len) {
+    while(len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if(n < 0 && errno == EINTR) continue;
+        if(n < 0) return false;
+        buf = (const char*)buf + n;
+        len -= n;
+    }
+    return true;
+}
+
+bool cache_store(const char* image, const char* source, const char* text, size_t len, const Ast* ast, Cached prog) {
+    struct stat st;
+    if(stat(source, &st) < 0) return false;
+    // The image may be run from another directory.
+    char path[PATH_MAX];
+    if(realpath(source, path) == NULL) return false;
+
+    Header h = {.format = CACHE_FORMAT, .hash = hash_text(text, len), .root = prog.root, .slots = prog.slots};
+    memcpy(h.magic, CACHE_MAGIC, 4);
+    memcpy(h.build, build, sizeof(build));
+    stamp(&h, &st);
+    h.path_len = strlen(path);
+    size_t page = sysconf(_SC_PAGESIZE);
+    h.arena_offset = (sizeof(h) + h.path_len + page - 1) & ~(page - 1);
+    h.arena_len = ast->arena.len;
+
+    size_t name_len = strlen(image);
+    char tmp[name_len + 8];
+    memcpy(tmp, image, name_len);
+    memcpy(tmp + name_len, ".XXXXXX", 8);
+    int fd = mkstemp(tmp);
+    if(fd < 0) return false;
+    char* pad = calloc(1, page);
+    size_t pad_len = h.arena_offset - sizeof(h) - h.path_len;
+    bool ok = fchmod(fd, 0644) == 0 && write_all(fd, &h, sizeof(h)) && write_all(fd, path, h.path_len)
+        && write_all(fd, pad, pad_len) && write_all(fd, ast->arena.base, h.arena_len);
+    free(pad);
+    int saved = errno;
+    close(fd);
+    if(ok && rename(tmp, image) == 0) return true;
+    if(ok) saved = errno;
+    unlink(tmp);
+    errno = saved;
+    return false;
+}
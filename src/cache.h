@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "parser.h"
+
+// Precompiled scripts. An image holds the sealed arena of a parsed and
+// optimized script, which refers to itself only by offset, so loading
+// one is a single read-only mmap with no scanning or name lookups.
+// Images are keyed by the build of sysh that wrote them and by the
+// contents of their source, whose path, size, mtime and hash they
+// record. A source whose size and mtime still match is trusted without
+// reading it; otherwise it is hashed.
+typedef enum {
+    CACHE_OK,
+    CACHE_STALE,      // an image, but of another build or source
+    CACHE_NONE,       // missing, unreadable or not an image
+} CacheStatus;
+
+typedef struct {
+    Block root;
+    int slots;
+} Cached;
+
+// The image path for a script: name.sysh becomes name.sysc, any other
+// name gets .sysc appended. Free the result.
+char* cache_path(const char* source);
+
+// Loads image into ast, which must be empty, if it is fresh for source.
+// The arena's place in the file and the root block's place in the arena
+// are checked, and an image that fails is rebuilt like a stale one. The
+// tree itself is trusted as this build wrote it: checking every offset
+// would touch every line, and loading would no longer be O(1). errno is
+// left as it was.
+CacheStatus cache_load(const char* image, const char* source, Ast* ast, Cached* prog);
+
+// Returns the source path recorded in image, stale or not, or NULL if
+// it is not an image. Free the result.
+char* cache_source(const char* image);
+
+// Writes the image of a script parsed from text, replacing any old one
+// atomically so processes still running it are not disturbed. Returns
+// false and leaves errno set if it cannot be written.
+bool cache_store(const char* image, const char* source, const char* text, size_t len, const Ast* ast, Cached prog);
@@ -0,0 +1,148 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "coalesce.h"
+#include "sys.h"
+
+// A pipe's default capacity, so one flush rarely blocks part way.
+#define COALESCE_BYTES (64 * 1024)
+
+bool coalesce_enabled = false;
+
+// Tasks started with .spawn share the buffer, so writes from different
+// threads still reach the fd in the order they were made.
+// fd is checked again after any other syscall, which may have closed or
+// replaced it; until then, bufferable says whether writes to it are.
+static struct {
+    pthread_mutex_t lock;
+    bool guarded;
+    bool checked;
+    bool bufferable;
+    long fd;
+    size_t len;
+    char data[COALESCE_BYTES];
+} out = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// Set while this thread copies a write's data into the buffer.
+static _Thread_local sigjmp_buf* recover;
+
+// A fault while copying a write is the script's bad address, which the
+// kernel would have answered with EFAULT. Any other fault is left to
+// happen again, with its default action.
+static void fault(int sig) {
+    if(recover != NULL) siglongjmp(*recover, 1);
+    signal(sig, SIG_DFL);
+}
+
+static void guard(void) {
+    // Without SA_NODEFER the signal would stay blocked after the jump.
+    struct sigaction sa = {.sa_handler = fault, .sa_flags = SA_NODEFER};
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, NULL);
+    sigaction(SIGBUS, &sa, NULL);
+    out.guarded = true;
+}
+
+// Copies len bytes of data to the end of the buffer. Returns false,
+// leaving the buffer as it was, if data is not all readable.
+static bool copy(const char* data, size_t len) {
+    sigjmp_buf here;
+    if(sigsetjmp(here, 0)) {
+        recover = NULL;
+        return false;
+    }
+    recover = &here;
+    memcpy(out.data + out.len, data, len);
+    recover = NULL;
+    out.len += len;
+    return true;
+}
+
+// Whether writes to fd can be buffered: those the kernel would refuse,
+// or might only take part of, are issued directly instead.
+static bool bufferable(long fd) {
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && (flags & O_ACCMODE) != O_RDONLY && (flags & (O_PATH | O_NONBLOCK)) == 0;
+}
+
+// Writes the buffer and then extra_len bytes of extra with as few
+// writevs as the fd allows. Returns how much of extra was written, or
+// -errno if none of it was. The buffer is empty afterwards, even if
+// writing it failed. Call with lock held.
+static long drain(const char* extra, size_t extra_len) {
+    size_t done = 0;
+    size_t sent = 0;
+    while(done < out.len || sent < extra_len) {
+        struct iovec iov[2];
+        int n = 0;
+        if(done < out.len) iov[n++] = (struct iovec){out.data + done, out.len - done};
+        if(sent < extra_len) iov[n++] = (struct iovec){(char*)extra + sent, extra_len - sent};
+        long args[6] = {out.fd, (long)iov, n, 0, 0, 0};
+        long result = sys_issue(SYS_writev, args);
+        if(result == -EINTR) continue;
+        long err = sys_error(result);
+        if(err != 0) {
+            if(done < out.len) fprintf(stderr, "sysh: E%ld: %s\n", err, strerror(err));
+            out.len = 0;
+            return (sent > 0) ? (long)sent : result;
+        }
+        size_t buffered = out.len - done;
+        if((size_t)result <= buffered) {
+            done += result;
+        } else {
+            done = out.len;
+            sent += result - buffered;
+        }
+    }
+    out.len = 0;
+    return sent;
+}
+
+long coalesce_call(long id, const long* args) {
+    pthread_mutex_lock(&out.lock);
+    if(!out.guarded) guard();
+    if(id != SYS_write || args[0] != out.fd) {
+        if(out.len > 0) drain(NULL, 0);
+        out.checked = false;
+    }
+    if(id == SYS_write && !out.checked) {
+        out.fd = args[0];
+        out.bufferable = bufferable(out.fd);
+        out.checked = true;
+    }
+    const char* data = (const char*)args[1];
+    size_t len = args[2];
+    bool fits = len <= COALESCE_BYTES - out.len;
+    if(id == SYS_write && out.bufferable && fits && copy(data, len)) {
+        pthread_mutex_unlock(&out.lock);
+        return len;
+    }
+    if(id == SYS_write && out.bufferable && !fits) {
+        // Too big to join the buffer: it goes out in the same writev.
+        long result = drain(data, len);
+        pthread_mutex_unlock(&out.lock);
+        return result;
+    }
+    // Everything else, including a write the copy found a bad address
+    // in, is the kernel's to answer, after what is buffered.
+    if(out.len > 0) drain(NULL, 0);
+    pthread_mutex_unlock(&out.lock);
+    return sys_issue(id, args);
+}
+
+void coalesce_flush(void) {
+    if(!coalesce_enabled) return;
+    pthread_mutex_lock(&out.lock);
+    if(out.len > 0) drain(NULL, 0);
+    pthread_mutex_unlock(&out.lock);
+}
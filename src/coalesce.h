@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Write coalescing for --coalesce. A script's writes to one fd are
+// copied into a buffer and reach the kernel together, so output made of
+// many small writes costs one syscall per buffer instead of one per
+// line.
+//
+// Each buffered write returns its full count at once, as a successful
+// write would. Writes the kernel would refuse or only partly take, to an
+// fd that is closed, not open for writing or non-blocking, or from an
+// address that cannot be read, are issued directly and return what they
+// would without coalescing. If the buffer later cannot be written, say
+// to a full disk, the error is reported on stderr and the buffered
+// output is dropped.
+//
+// Any other syscall a script makes writes the buffer out first, as do
+// .batch, .pspawn, an error message, a prompt, reading more of the
+// script and exit, so buffered output keeps its place among everything
+// else the script does.
+extern bool coalesce_enabled;
+
+// Issues a script's syscall with coalescing on. Returns -errno on
+// failure, like sys_direct.
+long coalesce_call(long id, const long* args);
+
+// Writes out whatever is buffered.
+void coalesce_flush(void);
@@ -0,0 +1,615 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "eval.h"
+#include "jit.h"
+#include "mem.h"
+#include "parser.h"
+#include "profile.h"
+#include "trie.h"
+
+// Failure stubs are emitted after the main code so the success path of a
+// line never has to jump over its own error handling.
+// Their messages are only formatted for stubs that something jumps to.
+typedef struct {
+    const char* name;
+    int depth;
+    int resume;
+    bool jumped;
+} Stub;
+
+typedef struct {
+    int stub;
+    int site;
+} Patch;
+
+typedef struct {
+    Ast* ast;
+    Program* p;
+    int depth;
+    // How many blocks the line being compiled is inside.
+    int nesting;
+    // The operand of the OP_DEPTH that every block compiled since ran
+    // through, or -1 after a jump or jump target.
+    int reached;
+    int stubs_len;
+    int stubs_capacity;
+    Stub* stubs;
+    int patches_len;
+    int patches_capacity;
+    Patch* patches;
+} Compiler;
+
+void program_init(Program* p) {
+    p->len = 0;
+    p->capacity = 0;
+    p->code = NULL;
+    p->msgs_len = 0;
+    p->msgs_capacity = 0;
+    p->msgs = NULL;
+    p->max_depth = 0;
+}
+
+void program_free(Program* p) {
+    for(int i = 0; i < p->msgs_len; i++) {
+        free(p->msgs[i]);
+    }
+    free(p->msgs);
+    free(p->code);
+    program_init(p);
+}
+
+static int emit(Compiler* c, long word) {
+    Program* p = c->p;
+    if(p->capacity <= p->len) {
+        int new_capacity = (p->capacity == 0 ? 64 : 2*(p->capacity));
+        p->code = mem_realloc(p->code, new_capacity * sizeof(long));
+        p->capacity = new_capacity;
+    }
+    p->code[p->len] = word;
+    return p->len++;
+}
+
+static void push(Compiler* c, int n) {
+    c->depth += n;
+    if(c->depth > c->p->max_depth) c->p->max_depth = c->depth;
+}
+
+static long message(Compiler* c, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static long message(Compiler* c, const char* format, ...) {
+    Program* p = c->p;
+    if(p->msgs_capacity <= p->msgs_len) {
+        int new_capacity = (p->msgs_capacity == 0 ? 8 : 2*(p->msgs_capacity));
+        p->msgs = mem_realloc(p->msgs, new_capacity * sizeof(char*));
+        p->msgs_capacity = new_capacity;
+    }
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    char* buf = mem_alloc(len + 1);
+    va_start(args, format);
+    vsnprintf(buf, len + 1, format, args);
+    va_end(args);
+    p->msgs[p->msgs_len] = buf;
+    return p->msgs_len++;
+}
+
+// Opens a failure stub for the line being compiled. Any argument that
+// fails jumps to it, and it unwinds the stack to the line's base depth.
+static int stub_open(Compiler* c, const char* name) {
+    if(c->stubs_capacity <= c->stubs_len) {
+        int new_capacity = (c->stubs_capacity == 0 ? 8 : 2*(c->stubs_capacity));
+        c->stubs = mem_realloc(c->stubs, new_capacity * sizeof(Stub));
+        c->stubs_capacity = new_capacity;
+    }
+    c->stubs[c->stubs_len] = (Stub){.name = name, .depth = c->depth, .resume = -1, .jumped = false};
+    return c->stubs_len++;
+}
+
+static void stub_patch(Compiler* c, int stub, int site) {
+    c->stubs[stub].jumped = true;
+    c->reached = -1;
+    if(c->patches_capacity <= c->patches_len) {
+        int new_capacity = (c->patches_capacity == 0 ? 8 : 2*(c->patches_capacity));
+        c->patches = mem_realloc(c->patches, new_capacity * sizeof(Patch));
+        c->patches_capacity = new_capacity;
+    }
+    c->patches[c->patches_len++] = (Patch){.stub = stub, .site = site};
+}
+
+static void stub_close(Compiler* c, int stub) {
+    c->stubs[stub].resume = c->p->len;
+    if(c->stubs[stub].jumped) c->reached = -1;
+}
+
+// Blocks that always run together share one OP_DEPTH, raised to the
+// deepest of them.
+static void reach(Compiler* c, int depth) {
+    if(c->reached < 0) {
+        emit(c, OP_DEPTH);
+        c->reached = emit(c, depth);
+    } else if(c->p->code[c->reached] < depth) {
+        c->p->code[c->reached] = depth;
+    }
+}
+
+static void compile_block(Compiler* c, Block block);
+
+// Compiles one argument, pushing its value. Strings are only accepted
+// where allow_str is set; everything the tree walker would reject as a
+// bad argument becomes a jump to the line's failure stub.
+static void compile_arg(Compiler* c, Argument* arg, bool allow_str, int stub) {
+    switch(arg->type) {
+        case ARG_NUM:
+            emit(c, OP_PUSH);
+            emit(c, arg->as.num);
+            push(c, 1);
+            return;
+        case ARG_STR:
+            if(!allow_str) break;
+            emit(c, OP_PUSHSTR);
+            emit(c, (long)ast_str(c->ast, arg));
+            push(c, 1);
+            return;
+        case ARG_BLOCK:
+            compile_block(c, arg->as.block);
+            return;
+        case ARG_VAR:
+            emit(c, OP_LOAD);
+            emit(c, arg->as.slot);
+            stub_patch(c, stub, emit(c, 0));
+            push(c, 1);
+            return;
+        case ARG_CMD:
+            break;
+    }
+    emit(c, OP_JMP);
+    stub_patch(c, stub, emit(c, 0));
+    push(c, 1);
+}
+
+static void compile_error(Compiler* c, long msg) {
+    emit(c, OP_ERROR);
+    emit(c, msg);
+    push(c, 1);
+}
+
+static void compile_syscall(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len > 6) {
+        compile_error(c, message(c, "too many arguments for syscall: got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, "syscall");
+    for(int i = 0; i < line->len; i++) {
+        compile_arg(c, &args[i], true, stub);
+    }
+    emit(c, OP_SYSCALL);
+    emit(c, line->id);
+    emit(c, line->len);
+    push(c, 1 - line->len);
+    stub_close(c, stub);
+}
+
+// Builtins that compile to their arguments followed by a single opcode.
+// String literals are only accepted where allow_str is set.
+static void compile_simple(Compiler* c, Line* line, const char* name, const char* expected, int argc, Opcode op, bool allow_str) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != argc) {
+        compile_error(c, message(c, "%s expected %s, got %d", name, expected, line->len));
+        return;
+    }
+    int stub = stub_open(c, name);
+    for(int i = 0; i < argc; i++) {
+        compile_arg(c, &args[i], allow_str, stub);
+    }
+    emit(c, op);
+    push(c, 1 - argc);
+    stub_close(c, stub);
+}
+
+static void compile_set(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len < 1 || line->len > 2) {
+        compile_error(c, message(c, ".set expected 1 or 2 args, got %d", line->len));
+        return;
+    }
+    if(args[0].type != ARG_VAR) {
+        compile_error(c, message(c, "bad argument to .set"));
+        return;
+    }
+    if(line->len == 2) {
+        int stub = stub_open(c, ".set");
+        compile_arg(c, &args[1], true, stub);
+        if(args[1].type == ARG_STR) emit(c, OP_CLONE);
+        emit(c, OP_SET);
+        emit(c, args[0].as.slot);
+        emit(c, OP_PUSH);
+        emit(c, 0);
+        stub_close(c, stub);
+    } else {
+        emit(c, OP_UNSET);
+        emit(c, args[0].as.slot);
+        emit(c, OP_PUSH);
+        emit(c, 0);
+        push(c, 1);
+    }
+}
+
+static void compile_cpy(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != 3) {
+        compile_error(c, message(c, ".cpy expected 3 arguments, got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, ".cpy");
+    compile_arg(c, &args[0], false, stub);
+    compile_arg(c, &args[2], false, stub);
+    compile_arg(c, &args[1], true, stub);
+    emit(c, OP_CPY);
+    push(c, -2);
+    stub_close(c, stub);
+}
+
+static void compile_deref(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != 1) {
+        compile_error(c, message(c, ".deref expected 1 argument, got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, ".deref");
+    compile_arg(c, &args[0], true, stub);
+    emit(c, OP_DEREF);
+    stub_close(c, stub);
+}
+
+static void compile_while(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != 2) {
+        compile_error(c, message(c, ".while expected 2 args, got %d", line->len));
+        return;
+    }
+    emit(c, OP_PUSH);
+    emit(c, 0);
+    push(c, 1);
+    int stub = stub_open(c, ".while");
+    c->stubs[stub].depth--;
+    // The condition runs at least once, so its blocks are recorded
+    // before the loop.
+    reach(c, c->nesting);
+    int top = c->p->len;
+    int hot = -1;
+    if(jit_enabled) {
+        emit(c, OP_LOOP);
+        emit(c, (long)c->ast);
+        emit(c, (long)line);
+        emit(c, 0);
+        hot = emit(c, 0);
+        emit(c, c->nesting);
+    }
+    compile_arg(c, &args[0], false, stub);
+    emit(c, OP_JZ);
+    int exit = emit(c, 0);
+    c->reached = -1;
+    push(c, -1);
+    emit(c, OP_POP);
+    push(c, -1);
+    compile_arg(c, &args[1], false, stub);
+    emit(c, OP_JMP);
+    emit(c, top);
+    c->p->code[exit] = c->p->len;
+    if(hot >= 0) c->p->code[hot] = c->p->len;
+    c->reached = -1;
+    stub_close(c, stub);
+}
+
+static void compile_if(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len < 2 || line->len > 3) {
+        compile_error(c, message(c, ".if expected 2 or 3 args, got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, ".if");
+    compile_arg(c, &args[0], false, stub);
+    emit(c, OP_JZ);
+    int other = emit(c, 0);
+    c->reached = -1;
+    push(c, -1);
+    compile_arg(c, &args[1], false, stub);
+    emit(c, OP_JMP);
+    int end = emit(c, 0);
+    push(c, -1);
+    c->p->code[other] = c->p->len;
+    c->reached = -1;
+    if(line->len == 3) {
+        compile_arg(c, &args[2], false, stub);
+    } else {
+        emit(c, OP_PUSH);
+        emit(c, 0);
+        push(c, 1);
+    }
+    c->p->code[end] = c->p->len;
+    c->reached = -1;
+    stub_close(c, stub);
+}
+
+static void compile_batch(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != 1 || args[0].type != ARG_BLOCK) {
+        compile_error(c, message(c, ".batch expected 1 block argument"));
+        return;
+    }
+    Block block = args[0].as.block;
+    Line* lines = ast_lines(c->ast, block);
+    int slot;
+    for(int i = 0; i < block.len; i++) {
+        if(batch_entry(c->ast, &lines[i], &slot) == NULL) {
+            compile_error(c, message(c, "only syscalls can be batched"));
+            return;
+        }
+    }
+    int stub = stub_open(c, ".batch");
+    int argc = 0;
+    for(int i = 0; i < block.len; i++) {
+        Line* call = batch_entry(c->ast, &lines[i], &slot);
+        Argument* call_args = ast_args(c->ast, call);
+        for(int j = 0; j < call->len; j++) {
+            compile_arg(c, &call_args[j], true, stub);
+        }
+        argc += call->len;
+    }
+    emit(c, OP_BATCH);
+    emit(c, block.len);
+    for(int i = 0; i < block.len; i++) {
+        Line* call = batch_entry(c->ast, &lines[i], &slot);
+        emit(c, call->id);
+        emit(c, call->len);
+        emit(c, slot);
+    }
+    push(c, 1 - argc);
+    stub_close(c, stub);
+}
+
+static void compile_spawn(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != 1 || args[0].type != ARG_BLOCK) {
+        compile_error(c, message(c, ".spawn expected 1 block argument"));
+        return;
+    }
+    // The block is compiled by the thread that runs it.
+    emit(c, OP_SPAWN);
+    emit(c, (long)c->ast);
+    emit(c, args[0].as.block.lines);
+    emit(c, args[0].as.block.len);
+    push(c, 1);
+}
+
+static void compile_pump(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len < 2 || line->len > 3) {
+        compile_error(c, message(c, ".pump expected 2 or 3 arguments, got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, ".pump");
+    for(int i = 0; i < line->len; i++) {
+        compile_arg(c, &args[i], false, stub);
+    }
+    if(line->len == 2) {
+        emit(c, OP_PUSH);
+        emit(c, -1);
+        push(c, 1);
+    }
+    emit(c, OP_PUMP);
+    push(c, -2);
+    stub_close(c, stub);
+}
+
+static void compile_pspawn(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len < 3 || line->len > 6) {
+        compile_error(c, message(c, ".pspawn expected 3 to 6 arguments, got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, ".pspawn");
+    for(int i = 0; i < line->len; i++) {
+        compile_arg(c, &args[i], true, stub);
+    }
+    for(int i = line->len; i < 6; i++) {
+        emit(c, OP_PUSH);
+        emit(c, -1);
+        push(c, 1);
+    }
+    emit(c, OP_PSPAWN);
+    push(c, -5);
+    stub_close(c, stub);
+}
+
+// The address .storeN and .pack write to may not be a string literal,
+// which lives in the sealed arena; the values written may.
+static void compile_store(Compiler* c, Line* line, const char* name, Opcode op) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len != 2) {
+        compile_error(c, message(c, "%s expected 2 arguments, got %d", name, line->len));
+        return;
+    }
+    int stub = stub_open(c, name);
+    compile_arg(c, &args[0], false, stub);
+    compile_arg(c, &args[1], true, stub);
+    emit(c, op);
+    push(c, -1);
+    stub_close(c, stub);
+}
+
+static void compile_pack(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len < 2) {
+        compile_error(c, message(c, ".pack expected at least 2 arguments, got %d", line->len));
+        return;
+    }
+    int stub = stub_open(c, ".pack");
+    for(int i = 0; i < line->len; i++) {
+        compile_arg(c, &args[i], i > 0, stub);
+    }
+    emit(c, OP_PACK);
+    emit(c, line->len - 2);
+    push(c, 1 - line->len);
+    stub_close(c, stub);
+}
+
+static void compile_unpack(Compiler* c, Line* line) {
+    Argument* args = ast_args(c->ast, line);
+    if(line->len < 2) {
+        compile_error(c, message(c, ".unpack expected at least 2 arguments, got %d", line->len));
+        return;
+    }
+    for(int i = 2; i < line->len; i++) {
+        if(args[i].type != ARG_VAR) {
+            compile_error(c, message(c, "bad argument to .unpack"));
+            return;
+        }
+    }
+    int stub = stub_open(c, ".unpack");
+    compile_arg(c, &args[0], true, stub);
+    compile_arg(c, &args[1], true, stub);
+    emit(c, OP_UNPACK);
+    emit(c, line->len - 2);
+    for(int i = 2; i < line->len; i++) {
+        emit(c, args[i].as.slot);
+    }
+    push(c, -1);
+    stub_close(c, stub);
+}
+
+static void compile_line(Compiler* c, Line* line) {
+    if(line->id >= 0) {
+        compile_syscall(c, line);
+    } else switch(line->id) {
+        case C_ALLOC:    compile_simple(c, line, ".alloc", "1 arg", 1, OP_ALLOC, false); break;
+        case C_REALLOC:  compile_simple(c, line, ".realloc", "2 args", 2, OP_REALLOC, false); break;
+        case C_FREE:     compile_simple(c, line, ".free", "1 args", 1, OP_FREE, false); break;
+        case C_SET:      compile_set(c, line); break;
+        case C_CPY:      compile_cpy(c, line); break;
+        case C_DEREF:    compile_deref(c, line); break;
+        case C_WHILE:    compile_while(c, line); break;
+        case C_IF:       compile_if(c, line); break;
+        case C_ADD:      compile_simple(c, line, ".add", "1 argument", 2, OP_ADD, false); break;
+        case C_SUB:      compile_simple(c, line, ".sub", "1 argument", 2, OP_SUB, false); break;
+        case C_MUL:      compile_simple(c, line, ".mul", "1 argument", 2, OP_MUL, false); break;
+        case C_DIV:      compile_simple(c, line, ".div", "1 argument", 2, OP_DIV, false); break;
+        case C_BATCH:    compile_batch(c, line); break;
+        case C_SPAWN:    compile_spawn(c, line); break;
+        case C_JOIN:     compile_simple(c, line, ".join", "1 argument", 1, OP_JOIN, false); break;
+        case C_FIND:
+            if(line->len == 4) compile_simple(c, line, ".find", "3 or 4 arguments", 4, OP_FIND, true);
+            else compile_simple(c, line, ".find", "3 or 4 arguments", 3, OP_FINDBYTE, true);
+            break;
+        case C_COUNT:    compile_simple(c, line, ".count", "3 arguments", 3, OP_COUNTBYTE, true); break;
+        case C_CMP:      compile_simple(c, line, ".cmp", "3 arguments", 3, OP_CMP, true); break;
+        case C_FILL:     compile_simple(c, line, ".fill", "3 arguments", 3, OP_FILL, false); break;
+        case C_MEMSTAT:  compile_simple(c, line, ".memstat", "1 argument", 1, OP_MEMSTAT, false); break;
+        case C_PUMP:     compile_pump(c, line); break;
+        case C_STATS:    compile_simple(c, line, ".stats", "1 argument", 1, OP_STATS, false); break;
+        case C_PSPAWN:   compile_pspawn(c, line); break;
+        case C_LOAD8:    compile_simple(c, line, ".load8", "1 argument", 1, OP_PEEK8, true); break;
+        case C_LOAD16:   compile_simple(c, line, ".load16", "1 argument", 1, OP_PEEK16, true); break;
+        case C_LOAD32:   compile_simple(c, line, ".load32", "1 argument", 1, OP_PEEK32, true); break;
+        case C_LOAD64:   compile_simple(c, line, ".load64", "1 argument", 1, OP_PEEK64, true); break;
+        case C_STORE8:   compile_store(c, line, ".store8", OP_POKE8); break;
+        case C_STORE16:  compile_store(c, line, ".store16", OP_POKE16); break;
+        case C_STORE32:  compile_store(c, line, ".store32", OP_POKE32); break;
+        case C_STORE64:  compile_store(c, line, ".store64", OP_POKE64); break;
+        case C_PACK:     compile_pack(c, line); break;
+        case C_UNPACK:   compile_unpack(c, line); break;
+        case C_VALUE:
+            emit(c, OP_PUSH);
+            emit(c, ast_args(c->ast, line)[0].as.num);
+            push(c, 1);
+            break;
+        default:
+            emit(c, OP_PUSH);
+            emit(c, 0);
+            push(c, 1);
+    }
+}
+
+static void compile_block(Compiler* c, Block block) {
+    Line* lines = ast_lines(c->ast, block);
+    reach(c, c->nesting + 1);
+    if(block.len == 0) {
+        emit(c, OP_PUSH);
+        emit(c, 0);
+        push(c, 1);
+        return;
+    }
+    c->nesting++;
+    for(int i = 0; i < block.len; i++) {
+        if(profile_enabled) {
+            emit(c, OP_ENTER);
+            emit(c, (long)&lines[i]);
+            emit(c, c->nesting - 1);
+        }
+        compile_line(c, &lines[i]);
+        emit(c, OP_LAST);
+        emit(c, lines[i].id);
+        if(i < block.len - 1) {
+            emit(c, OP_POP);
+            push(c, -1);
+        }
+    }
+    if(profile_enabled) {
+        emit(c, OP_LEAVE);
+        emit(c, c->nesting - 1);
+    }
+    c->nesting--;
+}
+
+// Emits the stubs that are actually jumped to, in patch order. Stub
+// messages are shared between lines failing in the same builtin.
+static void emit_stubs(Compiler* c) {
+    const char* names[16];
+    long msgs[16];
+    int cached = 0;
+    int* at = mem_alloc(c->stubs_len * sizeof(int));
+    for(int i = 0; i < c->stubs_len; i++) at[i] = -1;
+    for(int i = 0; i < c->patches_len; i++) {
+        Patch* patch = &c->patches[i];
+        Stub* s = &c->stubs[patch->stub];
+        if(at[patch->stub] == -1) {
+            long msg = -1;
+            for(int j = 0; j < cached; j++) {
+                if(names[j] == s->name) msg = msgs[j];
+            }
+            if(msg == -1) {
+                msg = message(c, "bad argument to %s", s->name);
+                if(cached < 16) {
+                    names[cached] = s->name;
+                    msgs[cached++] = msg;
+                }
+            }
+            at[patch->stub] = emit(c, OP_FAIL);
+            emit(c, msg);
+            emit(c, s->depth);
+            emit(c, s->resume);
+        }
+        c->p->code[patch->site] = at[patch->stub];
+    }
+    free(at);
+}
+
+void compile(Ast* ast, Block block, Program* p) {
+    Compiler c = {
+        .ast = ast, .p = p, .depth = 0, .nesting = 0, .reached = -1,
+        .stubs_len = 0, .stubs_capacity = 0, .stubs = NULL,
+        .patches_len = 0, .patches_capacity = 0, .patches = NULL,
+    };
+    compile_block(&c, block);
+    emit(&c, OP_HALT);
+    emit_stubs(&c);
+    free(c.stubs);
+    free(c.patches);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdbool.h>
+#include "parser.h"
+
+// Flat bytecode for the stack VM in vm.c. Every instruction is one opcode
+// word followed by its operands, all stored as longs in Program.code.
+// Jump targets are absolute indices into the code array.
+typedef enum {
+    OP_HALT,
+    OP_PUSH,     // value           -> push value
+    OP_PUSHSTR,  // str             -> push pointer into the constant pool
+    OP_CLONE,    //                 -> replace top string with a heap copy
+    OP_LOAD,     // slot fail       -> push variable, jump to fail if unset
+    OP_SET,      // slot            -> pop value into variable
+    OP_UNSET,    // slot            -> remove variable
+    OP_POP,      //                 -> drop top
+    OP_LAST,     // id              -> store top into $LAST, report errno,
+                 //                    count a line of id
+    OP_SYSCALL,  // id argc         -> pop argc args, push syscall result
+    OP_ALLOC,
+    OP_REALLOC,
+    OP_FREE,
+    OP_CPY,
+    OP_DEREF,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_BATCH,    // n (id argc slot)*n -> pop every op's args, push last result
+    OP_SPAWN,    // ast lines len   -> start the block as a task, push handle
+    OP_JOIN,     //                 -> replace top handle with task's result
+    OP_FINDBYTE,
+    OP_FIND,
+    OP_COUNTBYTE,
+    OP_CMP,
+    OP_FILL,
+    OP_MEMSTAT,
+    OP_PUMP,     //                 -> pop src dst n, push bytes moved, set $ERRNO
+    OP_STATS,
+    OP_PSPAWN,   //                 -> pop path argv envp in out err, push pid,
+                 //                    set $ERRNO
+    OP_PEEK8,    //                 -> replace top address with the value there
+    OP_PEEK16,
+    OP_PEEK32,
+    OP_PEEK64,
+    OP_POKE8,    //                 -> pop address value, store value, push 0
+    OP_POKE16,
+    OP_POKE32,
+    OP_POKE64,
+    OP_PACK,     // n               -> pop address layout and n values, push size
+    OP_UNPACK,   // n slot*n        -> pop address layout, set n variables,
+                 //                    push size
+    OP_DEPTH,    // nesting         -> record that blocks this deeply nested ran
+    OP_ENTER,    // line level      -> mark line as running at level
+    OP_LEAVE,    // level           -> leave the block at level
+    OP_JZ,       // target          -> pop, jump if zero
+    OP_JMP,      // target
+    OP_LOOP,     // ast line count exit depth -> count a .while iteration, run
+                 //                    it natively once hot and jump to exit
+    OP_ERROR,    // msg             -> report msg, push -1
+    OP_FAIL,     // msg depth resume -> report msg, unwind to depth, push -1
+    OP_COUNT,
+} Opcode;
+
+typedef struct {
+    int len;
+    int capacity;
+    long* code;
+    int msgs_len;
+    int msgs_capacity;
+    char** msgs;
+    int max_depth;
+} Program;
+
+void program_init(Program* p);
+void program_free(Program* p);
+
+// Compiles a parsed block into p. String operands point into the ast's
+// arena, so the ast must outlive the program.
+void compile(Ast* ast, Block block, Program* p);
@@ -5,39 +5,79 @@
 #include <errno.h>
 #include <stdarg.h>
 
+#include "buf.h"
+#include "coalesce.h"
 #include "eval.h"
-#include "hashmap.h"
+#include "heap.h"
+#include "jit.h"
+#include "layout.h"
+#include "mem.h"
 #include "parser.h"
+#include "profile.h"
+#include "pspawn.h"
+#include "pump.h"
 #include "scanner.h"
+#include "stats.h"
+#include "sys.h"
+#include "task.h"
 #include "trie.h"
 
+// How deeply eval_block is nested on this thread, and how deeply it was
+// when the line or task being run started.
+static _Thread_local long depth = 0;
+static _Thread_local long base = 0;
+
 static void log_error(const char* format, ...) {
     va_list args;
     va_start(args, format);
+    coalesce_flush();
+    // Tasks may log at the same time; keep each message on its own line.
+    flockfile(stderr);
     fprintf(stderr, "sysh: ");
     vfprintf(stderr, format, args);
     fprintf(stderr, "\n");
+    funlockfile(stderr);
+    va_end(args);
+}
+
+void vars_init(Vars* vars) {
+    vars->len = 0;
+    vars->values = NULL;
+    vars->set = NULL;
+}
+
+void vars_resize(Vars* vars, int len) {
+    if(len <= vars->len) return;
+    vars->values = mem_realloc(vars->values, len * sizeof(long));
+    vars->set = mem_realloc(vars->set, len * sizeof(bool));
+    for(int i = vars->len; i < len; i++) {
+        vars->values[i] = 0;
+        vars->set[i] = false;
+    }
+    vars->len = len;
+}
+
+void vars_free(Vars* vars) {
+    free(vars->values);
+    free(vars->set);
+    vars_init(vars);
 }
 
-bool eval_arg(Argument arg, long* result, bool* cloned, Hashmap* vars) {
+// String literals evaluate to a pointer into the sealed parse arena.
+// They are only accepted where allow_str is set.
+bool eval_arg(Ast* ast, Argument arg, long* result, bool allow_str, Vars* vars) {
     if(arg.type == ARG_NUM) {
         *result = arg.as.num;
-        if(cloned) *cloned = false;
         return true;
-    } else if(arg.type == ARG_STR && cloned != NULL) {
-        int len = strlen(arg.as.str);
-        char* buf = malloc(len + 1);
-        strcpy(buf, arg.as.str);
-        *result = (long)buf;
-        *cloned = true;
+    } else if(arg.type == ARG_STR && allow_str) {
+        *result = (long)ast_str(ast, &arg);
         return true;
     } else if(arg.type == ARG_BLOCK) {
-        *result = eval_block(&arg.as.block, vars);        
-        if(cloned) *cloned = false;
+        *result = eval_block(ast, arg.as.block, vars);        
         return true;
     } else if(arg.type == ARG_VAR) {
-        if(hashmap_get(vars, arg.as.str, result)) {
-            if(cloned) *cloned = false;
+        if(vars->set[arg.as.slot]) {
+            *result = vars->values[arg.as.slot];
             return true;
         } else {
             return false;
@@ -47,140 +87,164 @@ bool eval_arg(Argument arg, long* result, bool* cloned, Hashmap* vars) {
     }
 }
 
-static long eval_syscall(Line* line, Hashmap* vars) {
+// Evaluates every argument of line into vals.
+static bool eval_args(Ast* ast, Line* line, long* vals, bool allow_str, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    for(int i = 0; i < line->len; i++) {
+        if(!eval_arg(ast, args[i], &vals[i], allow_str, vars)) return false;
+    }
+    return true;
+}
+
+static long eval_syscall(Ast* ast, Line* line, Vars* vars) {
     if(line->len > 6) {
         log_error("too many arguments for syscall: got %d", line->len);
         return -1;
     }
-    long args[6] = {0,0,0,0,0,0};
-    bool cloned[6] = {0,0,0,0,0,0};
+    Argument* args = ast_args(ast, line);
+    long vals[6] = {0,0,0,0,0,0};
     for(int i = 0; i < line->len; i++) {
-        Argument arg = line->args[i];
-        if(!eval_arg(arg, &args[i], &cloned[i], vars)) {
-            for(int j = 0; j < line->len; j++) {
-                if(cloned[j]) free((void*)args[j]);
-            }
+        if(!eval_arg(ast, args[i], &vals[i], true, vars)) {
             log_error("bad argument to syscall");
             return -1;
         }
     }
-    long result = syscall(line->id, args[0], args[1], args[2], args[3], args[4], args[5]);
-    hashmap_add(vars, "ERRNO", errno);
-    for(int i = 0; i < line->len; i++) {
-        if(cloned[i]) free((void*)args[i]);
-    }
-    return result;
+    long result = sys_call(line->id, vals);
+    long err = sys_error(result);
+    vars->values[SLOT_ERRNO] = err;
+    vars->set[SLOT_ERRNO] = true;
+    if(err == 0) return result;
+    errno = err;
+    return -1;
 }
 
-static long eval_alloc(Line* line, Hashmap* vars) {
+static long eval_alloc(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 1) {
         log_error(".alloc expected 1 arg, got %d", line->len);
         return -1;
     }
     long val;
-    if(!eval_arg(line->args[0], &val, NULL, vars)) {
+    if(!eval_arg(ast, args[0], &val, false, vars)) {
         log_error("bad argument to .alloc");
         return -1;
     }
-    return (long)malloc(val);
+    return (long)heap_alloc(val);
 }
 
-static long eval_realloc(Line* line, Hashmap* vars) {
+static long eval_realloc(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 2) {
         log_error(".realloc expected 2 args, got %d", line->len);
         return -1;
     }
     long val1;
     long val2;
-    if(!eval_arg(line->args[0], &val1, NULL, vars)) {
+    if(!eval_arg(ast, args[0], &val1, false, vars)) {
         log_error("bad argument to .realloc");
         return -1;
     }
-    if(!eval_arg(line->args[1], &val2, NULL, vars)) {
+    if(!eval_arg(ast, args[1], &val2, false, vars)) {
         log_error("bad argument to .realloc");
         return -1;
     }
-    return (long)realloc((void*)val1, val2);
+    return (long)heap_realloc((void*)val1, val2);
 }
 
-static long eval_free(Line* line, Hashmap* vars) {
+static long eval_free(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 1) {
         log_error(".free expected 1 args, got %d", line->len);
         return -1;
     }
     long val;
-    if(!eval_arg(line->args[0], &val, NULL, vars)) {
+    if(!eval_arg(ast, args[0], &val, false, vars)) {
         log_error("bad argument to .free");
         return -1;
     }
-    free((void*)val);
+    heap_free((void*)val);
     return 0;
 }
 
-static long eval_set(Line* line, Hashmap* vars) {
-    if(line->len < 0 || line->len > 2) {
+static long eval_set(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len < 1 || line->len > 2) {
         log_error(".set expected 1 or 2 args, got %d", line->len);
         return -1;
     }
-    if(line->args[0].type != ARG_VAR) {
+    if(args[0].type != ARG_VAR) {
         log_error("bad argument to .set");
         return -1;
     }
     if(line->len == 2) {
         long val;
-        bool cloned;
-        if(!eval_arg(line->args[1], &val, &cloned, vars)) {
+        if(!eval_arg(ast, args[1], &val, true, vars)) {
             log_error("bad argument to .set");
             return -1;
         }
-        hashmap_add(vars, line->args[0].as.str, val);
+        // The script owns the value and may write through it, so literals
+        // are copied out of the read-only arena.
+        if(args[1].type == ARG_STR) {
+            val = (long)heap_strdup((const char*)val);
+            stats_bump(STAT_CLONES);
+        }
+        vars->values[args[0].as.slot] = val;
+        vars->set[args[0].as.slot] = true;
     } else {
-        hashmap_remove(vars, line->args[0].as.str);
+        vars->set[args[0].as.slot] = false;
     }
     return 0;
 }
 
-static long eval_while(Line* line, Hashmap* vars) {
+static long eval_while(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 2) {
         log_error(".while expected 2 args, got %d", line->len);
         return -1;
     }
     long result = 0;
+    int iterations = 0;
     while(true) {
         long val;
-        if(!eval_arg(line->args[0], &val, NULL, vars)) {
+        if(!eval_arg(ast, args[0], &val, false, vars)) {
             log_error("bad argument to .while");
             return -1;
         }
         if(!val) break;
-        if(!eval_arg(line->args[1], &result, NULL, vars)) {
+        if(!eval_arg(ast, args[1], &result, false, vars)) {
             log_error("bad argument to .while");
             return -1;
         }
+        if(jit_enabled && ++iterations == JIT_THRESHOLD) {
+            JitCode* jit = jit_get(ast, line, vars->len, depth - base);
+            if(jit != NULL && jit_run(jit, vars, &result)) return result;
+            if(jit != NULL) iterations = 0;
+        }
     }
     return result;
 }
 
-static long eval_if(Line* line, Hashmap* vars) {
+static long eval_if(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len < 2 || line->len > 3) {
         log_error(".if expected 2 or 3 args, got %d", line->len);
         return -1;
     }
     long val;
-    if(!eval_arg(line->args[0], &val, NULL, vars)) {
+    if(!eval_arg(ast, args[0], &val, false, vars)) {
         log_error("bad argument to .if");
         return -1;
     }
     if(val) {
         long result;
-        if(!eval_arg(line->args[1], &result, NULL, vars)) {
+        if(!eval_arg(ast, args[1], &result, false, vars)) {
             log_error("bad argument to .if");
             return -1;
         }
         return result;
     } else if(line->len == 3) {
         long result;
-        if(!eval_arg(line->args[2], &result, NULL, vars)) {
+        if(!eval_arg(ast, args[2], &result, false, vars)) {
             log_error("bad argument to .if");
             return -1;
         }
@@ -191,46 +255,126 @@ static long eval_if(Line* line, Hashmap* vars) {
     }
 }
 
-static long eval_cpy(Line* line, Hashmap* vars) {
+static long eval_cpy(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 3) {
         log_error(".cpy expected 3 arguments, got %d", line->len);
         return -1;
     }
     long dst;
-    if(!eval_arg(line->args[0], &dst, NULL, vars)) {
+    if(!eval_arg(ast, args[0], &dst, false, vars)) {
         log_error("bad argument to .cpy");
         return -1;
     }
     long n;
-    if(!eval_arg(line->args[2], &n, NULL, vars)) {
+    if(!eval_arg(ast, args[2], &n, false, vars)) {
         log_error("bad argument to .cpy");
         return -1;
     }
     long src;
-    bool cloned;
-    if(!eval_arg(line->args[1], &src, &cloned, vars)) {
+    if(!eval_arg(ast, args[1], &src, true, vars)) {
         log_error("bad argument to .cpy");
         return -1;
     }
     memcpy((void*)dst, (void*)src, n);
-    if(cloned) free((void*)src);
     return 0;
 }
 
-static long eval_deref(Line* line, Hashmap* vars) {
+static long eval_deref(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 1) {
         log_error(".deref expected 1 argument, got %d", line->len);
         return -1;
     }
     long val;
-    bool cloned;
-    if(!eval_arg(line->args[0], &val, &cloned, vars)) {
+    if(!eval_arg(ast, args[0], &val, true, vars)) {
         log_error("bad argument to .deref");
         return -1;
     }
-    long result = *((unsigned char*)val);
-    if(cloned) free((void*)val);
-    return result;
+    return *((unsigned char*)val);
+}
+
+static long eval_load(Ast* ast, Line* line, Vars* vars, const char* name, int width) {
+    if(line->len != 1) {
+        log_error("%s expected 1 argument, got %d", name, line->len);
+        return -1;
+    }
+    long addr;
+    if(!eval_args(ast, line, &addr, true, vars)) {
+        log_error("bad argument to %s", name);
+        return -1;
+    }
+    return layout_load((void*)addr, width);
+}
+
+static long eval_store(Ast* ast, Line* line, Vars* vars, const char* name, int width) {
+    if(line->len != 2) {
+        log_error("%s expected 2 arguments, got %d", name, line->len);
+        return -1;
+    }
+    // The address may not be a string literal, which is read-only.
+    Argument* args = ast_args(ast, line);
+    long vals[2];
+    if(!eval_arg(ast, args[0], &vals[0], false, vars) || !eval_arg(ast, args[1], &vals[1], true, vars)) {
+        log_error("bad argument to %s", name);
+        return -1;
+    }
+    layout_store((void*)vals[0], width, vals[1]);
+    return 0;
+}
+
+static long eval_pack(Ast* ast, Line* line, Vars* vars) {
+    if(line->len < 2) {
+        log_error(".pack expected at least 2 arguments, got %d", line->len);
+        return -1;
+    }
+    Argument* args = ast_args(ast, line);
+    long vals[line->len];
+    bool ok = eval_arg(ast, args[0], &vals[0], false, vars);
+    for(int i = 1; ok && i < line->len; i++) ok = eval_arg(ast, args[i], &vals[i], true, vars);
+    if(!ok) {
+        log_error("bad argument to .pack");
+        return -1;
+    }
+    long size = layout_pack((void*)vals[0], (const char*)vals[1], vals + 2, line->len - 2);
+    if(size < 0) log_error("bad layout for .pack");
+    return size;
+}
+
+static long eval_unpack(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len < 2) {
+        log_error(".unpack expected at least 2 arguments, got %d", line->len);
+        return -1;
+    }
+    long src;
+    long layout;
+    if(!eval_arg(ast, args[0], &src, true, vars) || !eval_arg(ast, args[1], &layout, true, vars)) {
+        log_error("bad argument to .unpack");
+        return -1;
+    }
+    for(int i = 2; i < line->len; i++) {
+        if(args[i].type != ARG_VAR) {
+            log_error("bad argument to .unpack");
+            return -1;
+        }
+    }
+    int n = line->len - 2;
+    long inline_fields[UNPACK_INLINE];
+    long* fields = inline_fields;
+    if(n > UNPACK_INLINE) fields = mem_alloc(n * sizeof(long));
+    long size = layout_unpack((void*)src, (const char*)layout, fields, n);
+    if(size < 0) {
+        log_error("bad layout for .unpack");
+        size = -1;
+    } else {
+        for(int i = 0; i < n; i++) {
+            vars->values[args[i + 2].as.slot] = fields[i];
+            vars->set[args[i + 2].as.slot] = true;
+        }
+    }
+    if(fields != inline_fields) free(fields);
+    return size;
 }
 
 static long fn_add(long a, long b) { return a + b; }
@@ -238,52 +382,308 @@ static long fn_sub(long a, long b) { return a - b; }
 static long fn_mul(long a, long b) { return a * b; }
 static long fn_div(long a, long b) { return a / b; }
 
-static long eval_op(Line* line, Hashmap* vars, const char* name, long (*op)(long, long)) {
+static long eval_op(Ast* ast, Line* line, Vars* vars, const char* name, long (*op)(long, long)) {
+    Argument* args = ast_args(ast, line);
     if(line->len != 2) {
         log_error("%s expected 1 argument, got %d", name, line->len);
         return -1;
     }
     long val1;
-    if(!eval_arg(line->args[0], &val1, NULL, vars)) {
+    if(!eval_arg(ast, args[0], &val1, false, vars)) {
         log_error("bad argument to %s", name);
         return -1;
     }
     long val2;
-    if(!eval_arg(line->args[1], &val2, NULL, vars)) {
+    if(!eval_arg(ast, args[1], &val2, false, vars)) {
         log_error("bad argument to %s", name);
         return -1;
     }
     return op(val1, val2);
 }
 
-static long eval_line(Line* line, Hashmap* vars) {
+Line* batch_entry(Ast* ast, Line* line, int* slot) {
+    *slot = -1;
+    if(line->id == C_SET && line->len == 2) {
+        Argument* args = ast_args(ast, line);
+        if(args[0].type != ARG_VAR || args[1].type != ARG_BLOCK || args[1].as.block.len != 1) {
+            return NULL;
+        }
+        *slot = args[0].as.slot;
+        line = ast_lines(ast, args[1].as.block);
+    }
+    if(line->id < 0 || line->len > 6) return NULL;
+    return line;
+}
+
+long batch_results(BatchOp* ops, int* slots, int len, Vars* vars) {
+    int err = 0;
+    for(int i = 0; i < len; i++) {
+        if(slots[i] >= 0) {
+            vars->values[slots[i]] = ops[i].result;
+            vars->set[slots[i]] = true;
+        }
+        if(ops[i].err > 0) {
+            err = ops[i].err;
+            log_error("E%d: %s", err, strerror(err));
+        }
+    }
+    vars->values[SLOT_ERRNO] = err;
+    vars->set[SLOT_ERRNO] = true;
+    errno = 0;
+    return len > 0 ? ops[len - 1].result : 0;
+}
+
+static long eval_batch(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len != 1 || args[0].type != ARG_BLOCK) {
+        log_error(".batch expected 1 block argument");
+        return -1;
+    }
+    Block block = args[0].as.block;
+    Line* lines = ast_lines(ast, block);
+    BatchOp inline_ops[BATCH_INLINE];
+    int inline_slots[BATCH_INLINE];
+    BatchOp* ops = inline_ops;
+    int* slots = inline_slots;
+    if(block.len > BATCH_INLINE) {
+        ops = mem_alloc(block.len * sizeof(BatchOp));
+        slots = mem_alloc(block.len * sizeof(int));
+    }
+    long result = -1;
+    for(int i = 0; i < block.len; i++) {
+        Line* call = batch_entry(ast, &lines[i], &slots[i]);
+        if(call == NULL) {
+            log_error("only syscalls can be batched");
+            goto done;
+        }
+        Argument* call_args = ast_args(ast, call);
+        ops[i] = (BatchOp){.id = call->id, .args = {0,0,0,0,0,0}};
+        for(int j = 0; j < call->len; j++) {
+            if(!eval_arg(ast, call_args[j], &ops[i].args[j], true, vars)) {
+                log_error("bad argument to .batch");
+                goto done;
+            }
+        }
+    }
+    batch_run(ops, block.len);
+    result = batch_results(ops, slots, block.len, vars);
+done:
+    if(ops != inline_ops) {
+        free(ops);
+        free(slots);
+    }
+    return result;
+}
+
+static long eval_spawn(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len != 1 || args[0].type != ARG_BLOCK) {
+        log_error(".spawn expected 1 block argument");
+        return -1;
+    }
+    return task_spawn(ast, args[0].as.block, vars);
+}
+
+static long eval_join(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len != 1) {
+        log_error(".join expected 1 argument, got %d", line->len);
+        return -1;
+    }
+    long handle;
+    if(!eval_arg(ast, args[0], &handle, false, vars)) {
+        log_error("bad argument to .join");
+        return -1;
+    }
+    long result;
+    if(!task_join(handle, &result)) {
+        log_error("bad handle to .join");
+        return -1;
+    }
+    return result;
+}
+
+static long eval_find(Ast* ast, Line* line, Vars* vars) {
+    if(line->len < 3 || line->len > 4) {
+        log_error(".find expected 3 or 4 arguments, got %d", line->len);
+        return -1;
+    }
+    long vals[4];
+    if(!eval_args(ast, line, vals, true, vars)) {
+        log_error("bad argument to .find");
+        return -1;
+    }
+    if(line->len == 3) return buf_find_byte((const void*)vals[0], vals[1], vals[2]);
+    return buf_find((const void*)vals[0], vals[1], (const void*)vals[2], vals[3]);
+}
+
+static long eval_count(Ast* ast, Line* line, Vars* vars) {
+    if(line->len != 3) {
+        log_error(".count expected 3 arguments, got %d", line->len);
+        return -1;
+    }
+    long vals[3];
+    if(!eval_args(ast, line, vals, true, vars)) {
+        log_error("bad argument to .count");
+        return -1;
+    }
+    return buf_count((const void*)vals[0], vals[1], vals[2]);
+}
+
+static long eval_cmp(Ast* ast, Line* line, Vars* vars) {
+    if(line->len != 3) {
+        log_error(".cmp expected 3 arguments, got %d", line->len);
+        return -1;
+    }
+    long vals[3];
+    if(!eval_args(ast, line, vals, true, vars)) {
+        log_error("bad argument to .cmp");
+        return -1;
+    }
+    return buf_cmp((const void*)vals[0], (const void*)vals[1], vals[2]);
+}
+
+static long eval_fill(Ast* ast, Line* line, Vars* vars) {
+    if(line->len != 3) {
+        log_error(".fill expected 3 arguments, got %d", line->len);
+        return -1;
+    }
+    long vals[3];
+    if(!eval_args(ast, line, vals, false, vars)) {
+        log_error("bad argument to .fill");
+        return -1;
+    }
+    return buf_fill((void*)vals[0], vals[1], vals[2]);
+}
+
+static long eval_memstat(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len != 1) {
+        log_error(".memstat expected 1 argument, got %d", line->len);
+        return -1;
+    }
+    long stat;
+    if(!eval_arg(ast, args[0], &stat, false, vars)) {
+        log_error("bad argument to .memstat");
+        return -1;
+    }
+    return heap_stat(stat);
+}
+
+static long eval_stats(Ast* ast, Line* line, Vars* vars) {
+    Argument* args = ast_args(ast, line);
+    if(line->len != 1) {
+        log_error(".stats expected 1 argument, got %d", line->len);
+        return -1;
+    }
+    long stat;
+    if(!eval_arg(ast, args[0], &stat, false, vars)) {
+        log_error("bad argument to .stats");
+        return -1;
+    }
+    return stats_get(stat);
+}
+
+static long eval_pump(Ast* ast, Line* line, Vars* vars) {
+    if(line->len < 2 || line->len > 3) {
+        log_error(".pump expected 2 or 3 arguments, got %d", line->len);
+        return -1;
+    }
+    long vals[3] = {0, 0, -1};
+    if(!eval_args(ast, line, vals, false, vars)) {
+        log_error("bad argument to .pump");
+        return -1;
+    }
+    errno = 0;
+    long result = pump(vals[0], vals[1], vals[2]);
+    vars->values[SLOT_ERRNO] = errno;
+    vars->set[SLOT_ERRNO] = true;
+    return result;
+}
+
+static long eval_pspawn(Ast* ast, Line* line, Vars* vars) {
+    if(line->len < 3 || line->len > 6) {
+        log_error(".pspawn expected 3 to 6 arguments, got %d", line->len);
+        return -1;
+    }
+    long vals[6] = {0, 0, 0, -1, -1, -1};
+    if(!eval_args(ast, line, vals, true, vars)) {
+        log_error("bad argument to .pspawn");
+        return -1;
+    }
+    errno = 0;
+    long result = pspawn((const char*)vals[0], (const char*)vals[1], (const char*)vals[2], vals[3], vals[4], vals[5]);
+    vars->values[SLOT_ERRNO] = errno;
+    vars->set[SLOT_ERRNO] = true;
+    return result;
+}
+
+static long eval_line(Ast* ast, Line* line, Vars* vars) {
+    stats_line(line->id);
     if(line->id >= 0) {
-        return eval_syscall(line, vars);
+        return eval_syscall(ast, line, vars);
     } else switch(line->id) {
-        case C_ALLOC:    return eval_alloc(line, vars);
-        case C_REALLOC:  return eval_realloc(line, vars);
-        case C_FREE:     return eval_free(line, vars);
-        case C_SET:      return eval_set(line, vars);
-        case C_CPY:      return eval_cpy(line, vars);
-        case C_DEREF:    return eval_deref(line, vars);
-        case C_WHILE:    return eval_while(line, vars);
-        case C_IF:       return eval_if(line, vars);
-        case C_ADD:      return eval_op(line, vars, ".add", fn_add);
-        case C_SUB:      return eval_op(line, vars, ".sub", fn_sub);
-        case C_MUL:      return eval_op(line, vars, ".mul", fn_mul);
-        case C_DIV:      return eval_op(line, vars, ".div", fn_div);
+        case C_ALLOC:    return eval_alloc(ast, line, vars);
+        case C_REALLOC:  return eval_realloc(ast, line, vars);
+        case C_FREE:     return eval_free(ast, line, vars);
+        case C_SET:      return eval_set(ast, line, vars);
+        case C_CPY:      return eval_cpy(ast, line, vars);
+        case C_DEREF:    return eval_deref(ast, line, vars);
+        case C_WHILE:    return eval_while(ast, line, vars);
+        case C_IF:       return eval_if(ast, line, vars);
+        case C_ADD:      return eval_op(ast, line, vars, ".add", fn_add);
+        case C_SUB:      return eval_op(ast, line, vars, ".sub", fn_sub);
+        case C_MUL:      return eval_op(ast, line, vars, ".mul", fn_mul);
+        case C_DIV:      return eval_op(ast, line, vars, ".div", fn_div);
+        case C_BATCH:    return eval_batch(ast, line, vars);
+        case C_SPAWN:    return eval_spawn(ast, line, vars);
+        case C_JOIN:     return eval_join(ast, line, vars);
+        case C_FIND:     return eval_find(ast, line, vars);
+        case C_COUNT:    return eval_count(ast, line, vars);
+        case C_CMP:      return eval_cmp(ast, line, vars);
+        case C_FILL:     return eval_fill(ast, line, vars);
+        case C_MEMSTAT:  return eval_memstat(ast, line, vars);
+        case C_PUMP:     return eval_pump(ast, line, vars);
+        case C_STATS:    return eval_stats(ast, line, vars);
+        case C_PSPAWN:   return eval_pspawn(ast, line, vars);
+        case C_LOAD8:    return eval_load(ast, line, vars, ".load8", 1);
+        case C_LOAD16:   return eval_load(ast, line, vars, ".load16", 2);
+        case C_LOAD32:   return eval_load(ast, line, vars, ".load32", 4);
+        case C_LOAD64:   return eval_load(ast, line, vars, ".load64", 8);
+        case C_STORE8:   return eval_store(ast, line, vars, ".store8", 1);
+        case C_STORE16:  return eval_store(ast, line, vars, ".store16", 2);
+        case C_STORE32:  return eval_store(ast, line, vars, ".store32", 4);
+        case C_STORE64:  return eval_store(ast, line, vars, ".store64", 8);
+        case C_PACK:     return eval_pack(ast, line, vars);
+        case C_UNPACK:   return eval_unpack(ast, line, vars);
+        case C_VALUE:    return ast_args(ast, line)[0].as.num;
         default: return 0; // unreachable
     }
 }
 
-long eval_block(Block* block, Hashmap* vars) {
+long eval_run(Ast* ast, Block block, Vars* vars) {
+    long saved = base;
+    base = depth;
+    long result = eval_block(ast, block, vars);
+    base = saved;
+    return result;
+}
+
+long eval_block(Ast* ast, Block block, Vars* vars) {
+    Line* lines = ast_lines(ast, block);
     long result = 0;
-    for(int i = 0; i < block->len; i++) {
-        result = eval_line(&block->lines[i], vars);
-        hashmap_add(vars, "LAST", result);
+    stats_depth(++depth - base);
+    for(int i = 0; i < block.len; i++) {
+        if(profile_enabled) shadow_enter(depth - 1, &lines[i]);
+        result = eval_line(ast, &lines[i], vars);
+        vars->values[SLOT_LAST] = result;
+        vars->set[SLOT_LAST] = true;
         if(errno > 0) {
             log_error("E%d: %s", errno, strerror(errno));
-        } 
+            errno = 0;
+        }
     }
+    if(profile_enabled) shadow_leave(depth - 1);
+    depth--;
     return result;
 }
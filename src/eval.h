@@ -1,6 +1,31 @@
 #pragma once
 
-#include "hashmap.h"
+#include <stdbool.h>
+#include "batch.h"
 #include "parser.h"
 
-long eval_block(Block* block, Hashmap* vars);
+// Variable storage, indexed by the slots assigned in Symbols.
+typedef struct {
+    int len;
+    long* values;
+    bool* set;
+} Vars;
+
+void vars_init(Vars* vars);
+void vars_resize(Vars* vars, int len);
+void vars_free(Vars* vars);
+
+long eval_block(Ast* ast, Block block, Vars* vars);
+
+// Runs a top-level line or a task's block. Blocks count as nested from
+// there, however deeply the caller itself is nested.
+long eval_run(Ast* ast, Block block, Vars* vars);
+
+// A .batch line is either a syscall or `.set $var { syscall }`. Returns
+// the syscall line and stores the target slot (or -1), or NULL if the
+// line cannot be batched.
+Line* batch_entry(Ast* ast, Line* line, int* slot);
+
+// Stores the results of a completed batch and reports its failures.
+// Returns the result of the last op.
+long batch_results(BatchOp* ops, int* slots, int len, Vars* vars);
@@ -1,3 +1,4 @@
+#include <emmintrin.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -5,103 +6,169 @@
 #include <string.h>
 
 #include "hashmap.h"
+#include "mem.h"
+#include "stats.h"
 
-static uint32_t hash_string(const char* key) {
-    uint32_t hash = 2166136261u;
+// Control bytes. A full slot holds the low seven bits of its key's hash,
+// so the top bit tells free slots from full ones.
+#define CTRL_EMPTY   0x80
+#define CTRL_DELETED 0xfe
+
+// At most 7/8 of the slots may be full or deleted, so every probe meets
+// an empty slot before it runs out of groups.
+#define MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+static uint64_t hash_string(const char* key) {
+    uint64_t hash = 14695981039346656037u;
     while(*key != '\0') {
         hash ^= (uint8_t)(*key);
-        hash *= 16777619;
+        hash *= 1099511628211u;
         key++;
     }
+    // FNV leaves the low bits, which become the control byte, poorly
+    // mixed; finish with the murmur3 avalanche.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdu;
+    hash ^= hash >> 33;
     return hash;
 }
 
+static uint8_t tag(uint64_t hash) {
+    return hash & 0x7f;
+}
+
+static unsigned match(const uint8_t* group, uint8_t ctrl) {
+    __m128i bytes = _mm_loadu_si128((const __m128i*)group);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(ctrl)));
+}
+
+// The probe visits whole, aligned groups in triangular order, which
+// reaches every group of a power-of-two table.
+typedef struct {
+    size_t mask;
+    size_t pos;
+    size_t step;
+} Probe;
+
+static Probe probe_start(const Hashmap* map, uint64_t hash) {
+    size_t mask = map->capacity - 1;
+    return (Probe){.mask = mask, .pos = (hash >> 7) & mask & ~(size_t)(HASHMAP_GROUP - 1), .step = 0};
+}
+
+static void probe_next(Probe* p) {
+    stats_bump(STAT_PROBES);
+    p->step += HASHMAP_GROUP;
+    p->pos = (p->pos + p->step) & p->mask;
+}
+
 void hashmap_init(Hashmap* hashmap) {
     hashmap->len = 0;
+    hashmap->deleted = 0;
     hashmap->capacity = 0;
+    hashmap->ctrl = NULL;
     hashmap->entries = NULL;
 }
 
 void hashmap_free(Hashmap* hashmap) {
     for(int i = 0; i < hashmap->capacity; i++) {
-        Entry e = hashmap->entries[i];
-        if(e.key != NULL) free((char*)e.key);
+        if(!(hashmap->ctrl[i] & 0x80)) free((char*)hashmap->entries[i].key);
     }
+    free(hashmap->ctrl);
     free(hashmap->entries);
     hashmap_init(hashmap);
 }
 
-static Entry* hashmap_find(Entry* entries, int capacity, const char* key) {
-    uint32_t index = hash_string(key) % capacity;
-    Entry* tombstone = NULL;
+// Returns the slot holding key, or -1.
+static long hashmap_find(const Hashmap* map, const char* key, uint64_t hash) {
+    if(map->capacity == 0) return -1;
+    Probe p = probe_start(map, hash);
+    stats_bump(STAT_PROBES);
     while(true) {
-        Entry* entry = &entries[index];
-        if(entry->key == NULL) {
-            if(entry->value == 1) {
-                if(tombstone == NULL) tombstone = entry;
-            } else {
-                return (tombstone == NULL) ? entry : tombstone;
-            }
-        } else if(strcmp(entry->key, key) == 0) {
-            return entry;
+        const uint8_t* group = map->ctrl + p.pos;
+        for(unsigned bits = match(group, tag(hash)); bits != 0; bits &= bits - 1) {
+            size_t slot = p.pos + __builtin_ctz(bits);
+            Entry* e = &map->entries[slot];
+            if(e->hash == hash && strcmp(e->key, key) == 0) return slot;
         }
+        if(match(group, CTRL_EMPTY) != 0) return -1;
+        probe_next(&p);
     }
 }
 
-static void hashmap_grow(Hashmap* map, int capacity) {
-    Entry* entries = malloc(capacity * sizeof(Entry));
-    for(int i = 0; i < capacity; i++) {
-        entries[i].key = NULL;
-        entries[i].value = 0;
-    }
-    map->len = 0;
-    for(int i = 0; i < map->capacity; i++) {
-        Entry* entry = &map->entries[i];
-        if(entry->key == NULL) continue;
-        
-        Entry* dest = hashmap_find(entries, capacity, entry->key);
-        dest->key = entry->key;
-        dest->value = entry->value;
-        map->len++;
+// Returns the first empty or deleted slot on hash's probe sequence.
+static size_t hashmap_free_slot(const Hashmap* map, uint64_t hash) {
+    Probe p = probe_start(map, hash);
+    stats_bump(STAT_PROBES);
+    while(true) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(map->ctrl + p.pos));
+        unsigned bits = _mm_movemask_epi8(bytes);
+        if(bits != 0) return p.pos + __builtin_ctz(bits);
+        probe_next(&p);
     }
-    free(map->entries);
+}
 
-    map->entries = entries;
+// Rebuilds the table with the given capacity, dropping deleted slots.
+static void hashmap_resize(Hashmap* map, int capacity) {
+    stats_bump(STAT_RESIZES);
+    Hashmap old = *map;
     map->capacity = capacity;
+    map->deleted = 0;
+    map->ctrl = mem_alloc(capacity);
+    memset(map->ctrl, CTRL_EMPTY, capacity);
+    map->entries = mem_alloc(capacity * sizeof(Entry));
+    for(int i = 0; i < old.capacity; i++) {
+        if(old.ctrl[i] & 0x80) continue;
+        size_t slot = hashmap_free_slot(map, old.entries[i].hash);
+        map->ctrl[slot] = old.ctrl[i];
+        map->entries[slot] = old.entries[i];
+    }
+    free(old.ctrl);
+    free(old.entries);
 }
 
 bool hashmap_get(Hashmap* hashmap, const char* key, long* value) {
-    if(hashmap->len == 0) return false;
-
-    Entry* e = hashmap_find(hashmap->entries, hashmap->capacity, key);
-    if(e->key == NULL) return false;
-
-    *value = e->value;
+    long slot = hashmap_find(hashmap, key, hash_string(key));
+    if(slot < 0) return false;
+    *value = hashmap->entries[slot].value;
     return true;
 }
 
 bool hashmap_add(Hashmap* hashmap, const char* key, long value) {
-    if(hashmap->len + 1 > hashmap->capacity * TABLE_MAX_LOAD) {
-        int capacity = (hashmap->capacity == 0 ? 8 : (2 * hashmap->capacity));
-        hashmap_grow(hashmap, capacity);
+    uint64_t hash = hash_string(key);
+    long slot = hashmap_find(hashmap, key, hash);
+    if(slot >= 0) {
+        hashmap->entries[slot].value = value;
+        return false;
     }
-    Entry* e = hashmap_find(hashmap->entries, hashmap->capacity, key);
-    bool new_key = e->key == NULL;
-    if(new_key) {
-        hashmap->len++;
-        e->key = strdup(key);
+    if(hashmap->len + hashmap->deleted + 1 > MAX_LOAD(hashmap->capacity)) {
+        // When deleted slots make up most of the load, clearing them is
+        // enough; otherwise the table doubles.
+        int capacity = hashmap->capacity;
+        if(capacity == 0) capacity = HASHMAP_GROUP;
+        else if(hashmap->len + 1 > MAX_LOAD(capacity) / 2) capacity *= 2;
+        hashmap_resize(hashmap, capacity);
     }
-    e->value = value;                
-    return new_key;
+    size_t free_slot = hashmap_free_slot(hashmap, hash);
+    if(hashmap->ctrl[free_slot] == CTRL_DELETED) hashmap->deleted--;
+    hashmap->ctrl[free_slot] = tag(hash);
+    hashmap->entries[free_slot] = (Entry){.key = mem_strdup(key), .hash = hash, .value = value};
+    hashmap->len++;
+    return true;
 }
 
 bool hashmap_remove(Hashmap* hashmap, const char* key) {
-    if(hashmap->len == 0) return false;
-
-    Entry* e = hashmap_find(hashmap->entries, hashmap->capacity, key);
-    if(e->key == NULL) return false;
-
-    e->key = NULL;
-    e->value = 1;
+    long slot = hashmap_find(hashmap, key, hash_string(key));
+    if(slot < 0) return false;
+    free((char*)hashmap->entries[slot].key);
+    // A probe only moves past a group that has no empty slot, so if this
+    // group has one, no probe can need the slot to stay marked.
+    const uint8_t* group = hashmap->ctrl + (slot & ~(long)(HASHMAP_GROUP - 1));
+    if(match(group, CTRL_EMPTY) != 0) {
+        hashmap->ctrl[slot] = CTRL_EMPTY;
+    } else {
+        hashmap->ctrl[slot] = CTRL_DELETED;
+        hashmap->deleted++;
+    }
+    hashmap->len--;
     return true;
 }
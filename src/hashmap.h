@@ -1,23 +1,34 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 
-#define TABLE_MAX_LOAD 0.75
+// An open-addressing table in the style of Swiss tables. Next to the
+// entries is one control byte per slot, either empty, deleted, or seven
+// bits of the key's hash. Lookups compare a whole group of 16 control
+// bytes at once with SSE2 and only look at entries whose bits match.
+// Entries keep their full hash, so growing never rehashes a key and
+// most mismatches are rejected without touching the key. The table owns
+// a copy of every key it holds.
+#define HASHMAP_GROUP 16
 
 typedef struct {
     const char* key;
+    uint64_t hash;
     long value;
 } Entry;
 
 typedef struct {
     int len;
+    int deleted;
     int capacity;
+    uint8_t* ctrl;
     Entry* entries;
 } Hashmap;
 
 void hashmap_init(Hashmap* hashmap);
 void hashmap_free(Hashmap* hashmap);
 
+// Returns true if key was not in the table before.
 bool hashmap_add(Hashmap* hashmap, const char* key, long value);
 bool hashmap_get(Hashmap* hashmap, const char* key, long* value);
 bool hashmap_remove(Hashmap* hashmap, const char* key);
-
@@ -0,0 +1,189 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heap.h"
+
+// Sizes up to 128 go in steps of 16, then four classes per power of two
+// up to HEAP_SMALL.
+#define CLASSES 28
+#define LARGE -1
+#define SLAB_BYTES (64 * 1024)
+
+// Each block starts with a header, which keeps the payload 16-byte
+// aligned. Free small blocks reuse their payload as the list link.
+typedef struct {
+    long size;
+    long cls;
+} Header;
+
+typedef struct Free {
+    struct Free* next;
+} Free;
+
+// Each thread counts its own allocations, so counting costs no locked
+// instructions. Other threads only read the counts, which are kept apart
+// from the thread's cache so they outlive it. They are never freed.
+typedef struct Counters {
+    long stats[HEAP_STAT_COUNT];
+    struct Counters* next;
+} Counters;
+
+// Per-thread state: one free list per class, and the unused end of the
+// slab each class was last carving blocks from. A block freed on another
+// thread joins that thread's list.
+static _Thread_local struct {
+    Free* lists[CLASSES];
+    char* bump[CLASSES];
+    char* end[CLASSES];
+    Counters* counters;
+} cache;
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static Counters* registry = NULL;
+
+static int class_of(long size) {
+    if(size <= 128) return size <= 16 ? 0 : (size - 1) >> 4;
+    int k = 63 - __builtin_clzl(size - 1);
+    int step = (size - 1) >> (k - 2);
+    return 8 + (k - 7) * 4 + (step - 4);
+}
+
+static const long class_sizes[CLASSES] = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256, 320, 384, 448, 512,
+    640, 768, 896, 1024, 1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096,
+};
+
+static Counters* join_registry(void) {
+    Counters* counters = calloc(1, sizeof(Counters));
+    if(counters == NULL) abort();
+    pthread_mutex_lock(&registry_lock);
+    counters->next = registry;
+    registry = counters;
+    pthread_mutex_unlock(&registry_lock);
+    return counters;
+}
+
+// Only this thread writes its counters. The atomic stores are plain
+// moves, but let other threads read the counts while they change.
+static void bump(long* counter, long by) {
+    __atomic_store_n(counter, *counter + by, __ATOMIC_RELAXED);
+}
+
+static void account(long bytes, long blocks) {
+    Counters* c = cache.counters;
+    if(c == NULL) c = cache.counters = join_registry();
+    bump(&c->stats[HEAP_LIVE], bytes);
+    bump(&c->stats[HEAP_BLOCKS], blocks);
+    if(blocks > 0) bump(&c->stats[HEAP_ALLOCS], blocks);
+    if(c->stats[HEAP_LIVE] > c->stats[HEAP_PEAK]) {
+        __atomic_store_n(&c->stats[HEAP_PEAK], c->stats[HEAP_LIVE], __ATOMIC_RELAXED);
+    }
+}
+
+static Header* take(int cls) {
+    Free* block = cache.lists[cls];
+    if(block != NULL) {
+        cache.lists[cls] = block->next;
+        return (Header*)block - 1;
+    }
+    long stride = sizeof(Header) + class_sizes[cls];
+    if(cache.end[cls] - cache.bump[cls] < stride) {
+        // The rest of the old slab is left unused; slabs are never
+        // returned, as their blocks are recycled through the lists.
+        char* slab = malloc(SLAB_BYTES);
+        if(slab == NULL) return NULL;
+        cache.bump[cls] = slab;
+        cache.end[cls] = slab + SLAB_BYTES;
+    }
+    Header* header = (Header*)cache.bump[cls];
+    cache.bump[cls] += stride;
+    return header;
+}
+
+void* heap_alloc(long size) {
+    if(size < 0) return NULL;
+    Header* header;
+    int cls = LARGE;
+    if(size <= HEAP_SMALL) {
+        cls = class_of(size);
+        header = take(cls);
+    } else {
+        header = malloc(sizeof(Header) + size);
+    }
+    if(header == NULL) return NULL;
+    header->size = size;
+    header->cls = cls;
+    account(size, 1);
+    return header + 1;
+}
+
+void heap_free(void* ptr) {
+    if(ptr == NULL) return;
+    Header* header = (Header*)ptr - 1;
+    account(-header->size, -1);
+    if(header->cls == LARGE) {
+        free(header);
+        return;
+    }
+    Free* block = ptr;
+    block->next = cache.lists[header->cls];
+    cache.lists[header->cls] = block;
+}
+
+void* heap_realloc(void* ptr, long size) {
+    if(ptr == NULL) return heap_alloc(size);
+    if(size == 0) {
+        heap_free(ptr);
+        return NULL;
+    }
+    if(size < 0) return NULL;
+    Header* header = (Header*)ptr - 1;
+    // Anything that still fits the block's class stays in place.
+    if(header->cls != LARGE && size <= class_sizes[header->cls]) {
+        account(size - header->size, 0);
+        header->size = size;
+        return ptr;
+    }
+    if(header->cls == LARGE && size > HEAP_SMALL) {
+        long old = header->size;
+        header = realloc(header, sizeof(Header) + size);
+        if(header == NULL) return NULL;
+        header->size = size;
+        account(size - old, 0);
+        return header + 1;
+    }
+    void* moved = heap_alloc(size);
+    if(moved == NULL) return NULL;
+    memcpy(moved, ptr, header->size < size ? header->size : size);
+    heap_free(ptr);
+    return moved;
+}
+
+char* heap_strdup(const char* str) {
+    size_t len = strlen(str) + 1;
+    char* copy = heap_alloc(len);
+    if(copy != NULL) memcpy(copy, str, len);
+    return copy;
+}
+
+long heap_stat(long stat) {
+    if(stat < 0 || stat >= HEAP_STAT_COUNT) return -1;
+    long total = 0;
+    pthread_mutex_lock(&registry_lock);
+    for(Counters* c = registry; c != NULL; c = c->next) {
+        total += __atomic_load_n(&c->stats[stat], __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return total;
+}
+
+void heap_report(FILE* out) {
+    long blocks = heap_stat(HEAP_BLOCKS);
+    if(blocks == 0) return;
+    fprintf(out, "sysh: %ld bytes in %ld script allocations never freed (peak %ld bytes)\n",
+            heap_stat(HEAP_LIVE), blocks, heap_stat(HEAP_PEAK));
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdio.h>
+
+// Memory owned by scripts: blocks from .alloc and .realloc, and the
+// copies .set makes of string literals, all of which .free releases.
+// Requests up to HEAP_SMALL bytes are served from per-thread free lists
+// of fixed size classes, carved out of larger slabs, so allocating and
+// freeing scratch buffers in a loop takes no locks. Larger requests go
+// to malloc. Every block is accounted for, so leaks can be reported.
+#define HEAP_SMALL 4096
+
+// The statistics .memstat returns, selected by its argument.
+typedef enum {
+    HEAP_LIVE,        // bytes currently allocated
+    HEAP_PEAK,        // most bytes ever allocated at once; when several
+                      // threads allocate, the sum of each one's peak
+    HEAP_ALLOCS,      // allocations made so far
+    HEAP_BLOCKS,      // allocations not freed yet
+    HEAP_STAT_COUNT,
+} HeapStat;
+
+// A negative size fails and returns NULL.
+void* heap_alloc(long size);
+// Behaves like realloc: NULL allocates and size 0 frees.
+void* heap_realloc(void* ptr, long size);
+void heap_free(void* ptr);
+char* heap_strdup(const char* str);
+
+// Returns a statistic, or -1 for an unknown one.
+long heap_stat(long stat);
+
+// Prints a line about blocks that were never freed, if there are any.
+void heap_report(FILE* out);
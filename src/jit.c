@@ -0,0 +1,727 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "buf.h"
+#include "coalesce.h"
+#include "eval.h"
+#include "heap.h"
+#include "jit.h"
+#include "mem.h"
+#include "parser.h"
+#include "profile.h"
+#include "stats.h"
+#include "sys.h"
+#include "trie.h"
+#include "vdso.h"
+
+// A compiled loop is a function taking the variable arrays in rdi/rsi,
+// the loop's value so far in rdx, and the thread's Stats and Shadow in
+// rcx and r8, which are kept on the stack to count lines and syscalls
+// and, when profiling, to record the line running. Throughout, rbp holds values, r15
+// holds set, and up to four of the loop's most used variables live in
+// rbx and r12-r14. Expressions leave their value in rax; operands wait
+// on the machine stack. A failed syscall branches to a cold stub placed
+// after the function, which reports it the way eval_block would.
+//
+// The JIT handles syscalls, .add/.sub/.mul/.div, .deref, .loadN and
+// .storeN, .set of a number, .if, nested .while, folded constants, and
+// the buffer and script memory builtins, which are calls into buf.c and
+// heap.c. A loop may only be entered natively if every variable it
+// reads is already set, so the generated code never needs to check.
+
+enum { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+#define VAR_REGS 4
+static const int var_regs[VAR_REGS] = {RBX, R12, R13, R14};
+static const int arg_regs[6] = {RDI, RSI, RDX, R10, R8, R9};
+
+struct JitCode {
+    Line* line;
+    long (*fn)(long* values, bool* set, long result, Stats* stats, Shadow* shadow);
+    void* mem;
+    size_t size;
+    int reads_len;
+    int* reads;
+    JitCode* next;
+};
+
+typedef struct {
+    int site;
+    int count;
+    int back;
+} Cold;
+
+typedef struct {
+    Ast* ast;
+    int slots;
+    // Syscalls go through sys_call instead of an inline syscall
+    // instruction, so they can be traced or coalesced.
+    bool helper;
+    int len;
+    int capacity;
+    unsigned char* buf;
+    // Words pushed since entry, counting the return address. Calls need
+    // it to be even to keep the stack 16-byte aligned.
+    int count;
+    // The values of count once the Stats and Shadow pointers were pushed.
+    int stats;
+    int shadow;
+    // The shadow stack level of the next block to be generated.
+    long level;
+    // How many blocks the line being generated is inside, counted from
+    // the start of its line or task, and the immediate of the depth record
+    // every block generated since ran through, or -1 after a jump or jump
+    // target.
+    long nesting;
+    int reached;
+    int* uses;
+    bool* read;
+    int* reg;
+    int colds_len;
+    int colds_capacity;
+    Cold* colds;
+} Jit;
+
+bool jit_enabled = true;
+
+// Tasks started with .spawn may tier up loops on several threads.
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static JitCode* cache = NULL;
+
+static void report(long err) {
+    coalesce_flush();
+    fprintf(stderr, "sysh: E%ld: %s\n", err, strerror(err));
+}
+
+// sys_call is inline; generated code needs an address to call.
+static long helper_syscall(long id, const long* args) {
+    return sys_call(id, args);
+}
+
+static void byte(Jit* j, int b) {
+    if(j->capacity <= j->len) {
+        j->capacity = (j->capacity == 0 ? 256 : 2*j->capacity);
+        j->buf = mem_realloc(j->buf, j->capacity);
+    }
+    j->buf[j->len++] = b;
+}
+
+static void bytes(Jit* j, int n, const unsigned char* b) {
+    for(int i = 0; i < n; i++) byte(j, b[i]);
+}
+
+static void word32(Jit* j, int32_t v) {
+    for(int i = 0; i < 4; i++) byte(j, ((uint32_t)v >> (8 * i)) & 0xff);
+}
+
+static void word64(Jit* j, int64_t v) {
+    for(int i = 0; i < 8; i++) byte(j, ((uint64_t)v >> (8 * i)) & 0xff);
+}
+
+static void rex(Jit* j, bool w, int reg, int base) {
+    int r = 0x40 | (w << 3) | ((reg >> 3) << 2) | (base >> 3);
+    if(r != 0x40) byte(j, r);
+}
+
+// op reg, [base + disp]
+static void mem_op(Jit* j, int op, int reg, int base, int32_t disp) {
+    rex(j, true, reg, base);
+    byte(j, op);
+    byte(j, 0x80 | ((reg & 7) << 3) | (base & 7));
+    if((base & 7) == RSP) byte(j, 0x24);
+    word32(j, disp);
+}
+
+static void load(Jit* j, int reg, int base, int32_t disp) { mem_op(j, 0x8b, reg, base, disp); }
+static void store(Jit* j, int base, int32_t disp, int reg) { mem_op(j, 0x89, reg, base, disp); }
+
+static void mov(Jit* j, int dst, int src) {
+    rex(j, true, src, dst);
+    byte(j, 0x89);
+    byte(j, 0xc0 | ((src & 7) << 3) | (dst & 7));
+}
+
+static void mov_imm(Jit* j, int reg, long value) {
+    if(value == (int32_t)value) {
+        rex(j, true, 0, reg);
+        byte(j, 0xc7);
+        byte(j, 0xc0 | (reg & 7));
+        word32(j, value);
+    } else {
+        rex(j, true, 0, reg);
+        byte(j, 0xb8 | (reg & 7));
+        word64(j, value);
+    }
+}
+
+static void push(Jit* j, int reg) {
+    if(reg >= R8) byte(j, 0x41);
+    byte(j, 0x50 | (reg & 7));
+    j->count++;
+}
+
+static void pop(Jit* j, int reg) {
+    if(reg >= R8) byte(j, 0x41);
+    byte(j, 0x58 | (reg & 7));
+    j->count--;
+}
+
+// Emits a jump with a blank target and returns where to patch it.
+static int jump(Jit* j) {
+    byte(j, 0xe9);
+    word32(j, 0);
+    return j->len - 4;
+}
+
+static int jump_if(Jit* j, int cc) {
+    byte(j, 0x0f);
+    byte(j, cc);
+    word32(j, 0);
+    return j->len - 4;
+}
+
+#define CC_AE 0x83
+#define CC_Z  0x84
+#define CC_GE 0x8d
+
+static void patch(Jit* j, int site, int target) {
+    int32_t rel = target - (site + 4);
+    memcpy(&j->buf[site], &rel, 4);
+}
+
+static void land(Jit* j, int site) {
+    patch(j, site, j->len);
+}
+
+static void call(Jit* j, uintptr_t fn) {
+    bool pad = j->count % 2 == 1;
+    if(pad) bytes(j, 4, (unsigned char[]){0x48, 0x83, 0xec, 0x08});
+    rex(j, true, 0, RAX);
+    byte(j, 0xb8);
+    word64(j, (long)fn);
+    bytes(j, 2, (unsigned char[]){0xff, 0xd0});
+    if(pad) bytes(j, 4, (unsigned char[]){0x48, 0x83, 0xc4, 0x08});
+}
+
+// mov byte [r15 + slot], 1
+static void mark_set(Jit* j, int slot) {
+    byte(j, 0x41);
+    byte(j, 0xc6);
+    byte(j, 0x87);
+    word32(j, slot);
+    byte(j, 1);
+}
+
+static void load_var(Jit* j, int slot) {
+    if(j->reg[slot] >= 0) mov(j, RAX, j->reg[slot]);
+    else load(j, RAX, RBP, slot * 8);
+}
+
+static void store_var(Jit* j, int slot) {
+    if(j->reg[slot] >= 0) {
+        mov(j, j->reg[slot], RAX);
+    } else {
+        store(j, RBP, slot * 8, RAX);
+        mark_set(j, slot);
+    }
+}
+
+static bool scan_block(Jit* j, Block block);
+
+static bool scan_arg(Jit* j, Argument* arg, bool allow_str) {
+    switch(arg->type) {
+        case ARG_NUM:   return true;
+        case ARG_STR:   return allow_str;
+        case ARG_BLOCK: return scan_block(j, arg->as.block);
+        case ARG_VAR:
+            j->uses[arg->as.slot]++;
+            j->read[arg->as.slot] = true;
+            return true;
+        default:        return false;
+    }
+}
+
+static bool scan_args(Jit* j, Line* line, int from, bool allow_str) {
+    Argument* args = ast_args(j->ast, line);
+    for(int i = from; i < line->len; i++) {
+        if(!scan_arg(j, &args[i], allow_str)) return false;
+    }
+    return true;
+}
+
+// Checks that the JIT handles a line and counts its variable uses.
+static bool scan_line(Jit* j, Line* line) {
+    Argument* args = ast_args(j->ast, line);
+    if(line->id >= 0) return line->len <= 6 && scan_args(j, line, 0, true);
+    switch(line->id) {
+        case C_VALUE:
+            return true;
+        case C_ADD:
+        case C_SUB:
+        case C_MUL:
+        case C_DIV:
+            return line->len == 2 && scan_args(j, line, 0, false);
+        case C_DEREF:
+        case C_LOAD8:
+        case C_LOAD16:
+        case C_LOAD32:
+        case C_LOAD64:
+            return line->len == 1 && scan_args(j, line, 0, true);
+        case C_STORE8:
+        case C_STORE16:
+        case C_STORE32:
+        case C_STORE64:
+            return line->len == 2 && scan_arg(j, &args[0], false) && scan_arg(j, &args[1], true);
+        case C_SET:
+            // Unsetting, or setting a string that needs copying, stays
+            // in the interpreter.
+            if(line->len != 2 || args[0].type != ARG_VAR || args[1].type == ARG_STR) return false;
+            j->uses[args[0].as.slot]++;
+            return scan_args(j, line, 1, false);
+        case C_FIND:
+            return line->len >= 3 && line->len <= 4 && scan_args(j, line, 0, true);
+        case C_COUNT:
+        case C_CMP:
+            return line->len == 3 && scan_args(j, line, 0, true);
+        case C_FILL:
+            return line->len == 3 && scan_args(j, line, 0, false);
+        case C_ALLOC:
+        case C_FREE:
+        case C_MEMSTAT:
+        case C_STATS:
+            return line->len == 1 && scan_args(j, line, 0, false);
+        case C_REALLOC:
+            return line->len == 2 && scan_args(j, line, 0, false);
+        case C_IF:
+            return line->len >= 2 && line->len <= 3 && scan_args(j, line, 0, false);
+        case C_WHILE:
+            return line->len == 2 && scan_args(j, line, 0, false);
+        default:
+            return false;
+    }
+}
+
+static bool scan_block(Jit* j, Block block) {
+    for(int i = 0; i < block.len; i++) {
+        if(!scan_line(j, ast_lines(j->ast, block) + i)) return false;
+    }
+    return true;
+}
+
+// Gives registers to the most used variables. Only variables the loop
+// reads qualify, since those are known to be set on entry.
+static void assign_regs(Jit* j) {
+    for(int i = 0; i < j->slots; i++) j->reg[i] = -1;
+    for(int r = 0; r < VAR_REGS; r++) {
+        int best = -1;
+        for(int i = SLOT_ERRNO + 1; i < j->slots; i++) {
+            if(!j->read[i] || j->reg[i] >= 0) continue;
+            if(best == -1 || j->uses[i] > j->uses[best]) best = i;
+        }
+        if(best == -1) return;
+        j->reg[best] = var_regs[r];
+    }
+}
+
+static void gen_block(Jit* j, Block block);
+static void gen_loop(Jit* j, Line* line);
+
+// inc qword [stats + offset], with the thread's Stats pointer from the
+// stack. r11 is free here, as calls and syscalls clobber it anyway.
+static void bump_stat(Jit* j, size_t offset) {
+    load(j, R11, RSP, (j->count - j->stats) * 8);
+    mem_op(j, 0xff, 0, R11, offset);
+}
+
+// shadow_enter, using r10 and r11, which hold nothing between lines.
+static void gen_enter(Jit* j, Line* line, long level) {
+    load(j, R11, RSP, (j->count - j->shadow) * 8);
+    if(level < PROFILE_DEPTH) {
+        mov_imm(j, R10, (long)line);
+        store(j, R11, offsetof(Shadow, lines) + level * sizeof(Line*), R10);
+    }
+    // mov qword [r11 + depth], level + 1
+    mem_op(j, 0xc7, 0, R11, offsetof(Shadow, depth));
+    word32(j, level + 1);
+}
+
+// shadow_leave, keeping rax.
+static void gen_leave(Jit* j, long level) {
+    load(j, R11, RSP, (j->count - j->shadow) * 8);
+    mem_op(j, 0xc7, 0, R11, offsetof(Shadow, depth));
+    word32(j, level);
+}
+
+// Blocks that always run together share one record of how deep they
+// are nested, the way the compiler shares an OP_DEPTH. r10 and r11 hold
+// nothing between lines or before a block.
+static void reach(Jit* j, long depth) {
+    if(j->reached >= 0) {
+        int32_t imm;
+        memcpy(&imm, &j->buf[j->reached], 4);
+        if(imm < depth) {
+            imm = depth;
+            memcpy(&j->buf[j->reached], &imm, 4);
+        }
+        return;
+    }
+    size_t offset = offsetof(Stats, counts) + STAT_DEPTH * sizeof(long);
+    load(j, R11, RSP, (j->count - j->stats) * 8);
+    mov_imm(j, R10, depth);
+    j->reached = j->len - 4;
+    mem_op(j, 0x39, R10, R11, offset);
+    int skip = jump_if(j, CC_GE);
+    store(j, R11, offset, R10);
+    land(j, skip);
+}
+
+static void gen_arg(Jit* j, Argument* arg) {
+    switch(arg->type) {
+        case ARG_NUM:   mov_imm(j, RAX, arg->as.num); break;
+        case ARG_STR:   mov_imm(j, RAX, (long)ast_str(j->ast, arg)); break;
+        case ARG_VAR:   load_var(j, arg->as.slot); break;
+        case ARG_BLOCK: gen_block(j, arg->as.block); break;
+        default:        break; // rejected by scan_arg
+    }
+}
+
+static void gen_syscall(Jit* j, Line* line) {
+    Argument* args = ast_args(j->ast, line);
+    int argc = line->len;
+    for(int i = 0; i < argc; i++) {
+        gen_arg(j, &args[i]);
+        push(j, RAX);
+    }
+    // vDSO calls are cheaper than any syscall instruction, so those go
+    // through the helper too.
+    if(j->helper || ((unsigned long)line->id < SYSCALL_COUNT && vdso_table[line->id] != NULL)) {
+        // Copy the pushed arguments, which are in reverse, into a
+        // six-word array for helper_syscall.
+        bytes(j, 4, (unsigned char[]){0x48, 0x83, 0xec, 0x30});
+        j->count += 6;
+        for(int i = 0; i < 6; i++) {
+            if(i < argc) load(j, RAX, RSP, 48 + (argc - 1 - i) * 8);
+            else mov_imm(j, RAX, 0);
+            store(j, RSP, i * 8, RAX);
+        }
+        mov(j, RSI, RSP);
+        mov_imm(j, RDI, line->id);
+        call(j, (uintptr_t)helper_syscall);
+        bytes(j, 3, (unsigned char[]){0x48, 0x81, 0xc4});
+        word32(j, 48 + argc * 8);
+        j->count -= 6 + argc;
+    } else {
+        for(int i = argc - 1; i >= 0; i--) pop(j, arg_regs[i]);
+        // Optional arguments the script left out are zero, as in
+        // sys_direct.
+        for(int i = argc; i < syscall_args[line->id]; i++) mov_imm(j, arg_regs[i], 0);
+        bump_stat(j, offsetof(Stats, counts) + STAT_SYSCALLS * sizeof(long));
+        mov_imm(j, RAX, sys_id(line->id));
+        bytes(j, 2, (unsigned char[]){0x0f, 0x05});
+    }
+    // Results from -4095 to -1 are errors, as in libc.
+    bytes(j, 2, (unsigned char[]){0x48, 0x3d});
+    word32(j, -4095);
+    int site = jump_if(j, CC_AE);
+    // mov qword [rbp + ERRNO], 0
+    bytes(j, 3, (unsigned char[]){0x48, 0xc7, 0x85});
+    word32(j, SLOT_ERRNO * 8);
+    word32(j, 0);
+    mark_set(j, SLOT_ERRNO);
+    if(j->colds_capacity <= j->colds_len) {
+        j->colds_capacity = (j->colds_capacity == 0 ? 8 : 2*j->colds_capacity);
+        j->colds = mem_realloc(j->colds, j->colds_capacity * sizeof(Cold));
+    }
+    j->colds[j->colds_len++] = (Cold){.site = site, .count = j->count, .back = j->len};
+}
+
+static void gen_binary(Jit* j, Line* line) {
+    Argument* args = ast_args(j->ast, line);
+    gen_arg(j, &args[0]);
+    push(j, RAX);
+    gen_arg(j, &args[1]);
+    mov(j, RCX, RAX);
+    pop(j, RAX);
+    switch(line->id) {
+        case C_ADD: bytes(j, 3, (unsigned char[]){0x48, 0x01, 0xc8}); break;
+        case C_SUB: bytes(j, 3, (unsigned char[]){0x48, 0x29, 0xc8}); break;
+        case C_MUL: bytes(j, 4, (unsigned char[]){0x48, 0x0f, 0xaf, 0xc1}); break;
+        case C_DIV: bytes(j, 5, (unsigned char[]){0x48, 0x99, 0x48, 0xf7, 0xf9}); break;
+    }
+}
+
+// Calls a C function taking the line's arguments, at most four, in order.
+static void gen_call(Jit* j, Line* line, uintptr_t fn) {
+    static const int c_regs[4] = {RDI, RSI, RDX, RCX};
+    Argument* args = ast_args(j->ast, line);
+    for(int i = 0; i < line->len; i++) {
+        gen_arg(j, &args[i]);
+        push(j, RAX);
+    }
+    for(int i = line->len - 1; i >= 0; i--) pop(j, c_regs[i]);
+    call(j, fn);
+}
+
+// mov [address], value, at the width of a .storeN line.
+static void gen_store(Jit* j, Line* line) {
+    Argument* args = ast_args(j->ast, line);
+    gen_arg(j, &args[0]);
+    push(j, RAX);
+    gen_arg(j, &args[1]);
+    pop(j, RCX);
+    switch(line->id) {
+        case C_STORE8:  bytes(j, 2, (unsigned char[]){0x88, 0x01}); break;
+        case C_STORE16: bytes(j, 3, (unsigned char[]){0x66, 0x89, 0x01}); break;
+        case C_STORE32: bytes(j, 2, (unsigned char[]){0x89, 0x01}); break;
+        case C_STORE64: bytes(j, 3, (unsigned char[]){0x48, 0x89, 0x01}); break;
+    }
+    mov_imm(j, RAX, 0);
+}
+
+static void gen_test(Jit* j) {
+    bytes(j, 3, (unsigned char[]){0x48, 0x85, 0xc0});
+}
+
+static void gen_line(Jit* j, Line* line) {
+    Argument* args = ast_args(j->ast, line);
+    if(line->id >= 0) {
+        gen_syscall(j, line);
+        return;
+    }
+    switch(line->id) {
+        case C_VALUE:
+            mov_imm(j, RAX, args[0].as.num);
+            break;
+        case C_ADD:
+        case C_SUB:
+        case C_MUL:
+        case C_DIV:
+            gen_binary(j, line);
+            break;
+        case C_DEREF:
+        case C_LOAD8:
+            gen_arg(j, &args[0]);
+            // movzx eax, byte [rax]
+            bytes(j, 3, (unsigned char[]){0x0f, 0xb6, 0x00});
+            break;
+        case C_LOAD16:
+            gen_arg(j, &args[0]);
+            // movzx eax, word [rax]
+            bytes(j, 3, (unsigned char[]){0x0f, 0xb7, 0x00});
+            break;
+        case C_LOAD32:
+            gen_arg(j, &args[0]);
+            // mov eax, [rax], which clears the upper half
+            bytes(j, 2, (unsigned char[]){0x8b, 0x00});
+            break;
+        case C_LOAD64:
+            gen_arg(j, &args[0]);
+            bytes(j, 3, (unsigned char[]){0x48, 0x8b, 0x00});
+            break;
+        case C_STORE8:
+        case C_STORE16:
+        case C_STORE32:
+        case C_STORE64:
+            gen_store(j, line);
+            break;
+        case C_FIND:
+            gen_call(j, line, line->len == 4 ? (uintptr_t)buf_find : (uintptr_t)buf_find_byte);
+            break;
+        case C_COUNT: gen_call(j, line, (uintptr_t)buf_count); break;
+        case C_CMP:   gen_call(j, line, (uintptr_t)buf_cmp); break;
+        case C_FILL:  gen_call(j, line, (uintptr_t)buf_fill); break;
+        case C_ALLOC: gen_call(j, line, (uintptr_t)heap_alloc); break;
+        case C_REALLOC: gen_call(j, line, (uintptr_t)heap_realloc); break;
+        case C_MEMSTAT: gen_call(j, line, (uintptr_t)heap_stat); break;
+        case C_STATS:   gen_call(j, line, (uintptr_t)stats_get); break;
+        case C_FREE:
+            gen_call(j, line, (uintptr_t)heap_free);
+            mov_imm(j, RAX, 0);
+            break;
+        case C_SET:
+            gen_arg(j, &args[1]);
+            store_var(j, args[0].as.slot);
+            mov_imm(j, RAX, 0);
+            break;
+        case C_IF: {
+            gen_arg(j, &args[0]);
+            gen_test(j);
+            int other = jump_if(j, CC_Z);
+            j->reached = -1;
+            gen_arg(j, &args[1]);
+            int end = jump(j);
+            land(j, other);
+            j->reached = -1;
+            if(line->len == 3) gen_arg(j, &args[2]);
+            else mov_imm(j, RAX, 0);
+            land(j, end);
+            j->reached = -1;
+        } break;
+        case C_WHILE:
+            bytes(j, 2, (unsigned char[]){0x6a, 0x00});
+            j->count++;
+            gen_loop(j, line);
+            pop(j, RAX);
+            break;
+    }
+}
+
+static void gen_block(Jit* j, Block block) {
+    reach(j, j->nesting + 1);
+    if(block.len == 0) mov_imm(j, RAX, 0);
+    long level = j->level++;
+    j->nesting++;
+    for(int i = 0; i < block.len; i++) {
+        Line* line = ast_lines(j->ast, block) + i;
+        if(profile_enabled) gen_enter(j, line, level);
+        gen_line(j, line);
+        bump_stat(j, offsetof(Stats, lines) + (line->id + STATS_COMMANDS) * sizeof(long));
+        store(j, RBP, SLOT_LAST * 8, RAX);
+    }
+    if(profile_enabled && block.len > 0) gen_leave(j, level);
+    j->level--;
+    j->nesting--;
+}
+
+// The loop's value lives in the stack slot on top when this is called.
+static void gen_loop(Jit* j, Line* line) {
+    Argument* args = ast_args(j->ast, line);
+    // The condition runs at least once, so its blocks are recorded
+    // before the loop.
+    reach(j, j->nesting);
+    int top = j->len;
+    gen_arg(j, &args[0]);
+    gen_test(j);
+    int exit = jump_if(j, CC_Z);
+    j->reached = -1;
+    gen_arg(j, &args[1]);
+    store(j, RSP, 0, RAX);
+    patch(j, jump(j), top);
+    land(j, exit);
+    j->reached = -1;
+}
+
+static void gen_function(Jit* j, Line* line) {
+    j->count = 1;
+    static const int saved[] = {RBP, RBX, R12, R13, R14, R15};
+    for(int i = 0; i < 6; i++) push(j, saved[i]);
+    mov(j, RBP, RDI);
+    mov(j, R15, RSI);
+    for(int i = 0; i < j->slots; i++) {
+        if(j->reg[i] >= 0) load(j, j->reg[i], RBP, i * 8);
+    }
+    push(j, RCX);
+    j->stats = j->count;
+    push(j, R8);
+    j->shadow = j->count;
+    push(j, RDX);
+    gen_loop(j, line);
+    pop(j, RAX);
+    pop(j, R8);
+    pop(j, RCX);
+    for(int i = 0; i < j->slots; i++) {
+        if(j->reg[i] >= 0) store(j, RBP, i * 8, j->reg[i]);
+    }
+    for(int i = 5; i >= 0; i--) pop(j, saved[i]);
+    byte(j, 0xc3);
+
+    for(int i = 0; i < j->colds_len; i++) {
+        Cold* cold = &j->colds[i];
+        land(j, cold->site);
+        j->count = cold->count;
+        mov(j, RCX, RAX);
+        bytes(j, 3, (unsigned char[]){0x48, 0xf7, 0xd9});
+        store(j, RBP, SLOT_ERRNO * 8, RCX);
+        mark_set(j, SLOT_ERRNO);
+        mov(j, RDI, RCX);
+        call(j, (uintptr_t)report);
+        mov_imm(j, RAX, -1);
+        patch(j, jump(j), cold->back);
+    }
+}
+
+static void compile_loop(JitCode* code, Ast* ast, Line* line, int slots, long depth) {
+    // The loop line is on top of this thread's shadow stack, so the
+    // blocks inside it are a level further in.
+    Jit j = {
+        .ast = ast, .slots = slots, .helper = trace_enabled || coalesce_enabled, .level = shadow.depth,
+        .nesting = depth, .reached = -1,
+        .len = 0, .capacity = 0, .buf = NULL, .count = 0,
+        .colds_len = 0, .colds_capacity = 0, .colds = NULL,
+    };
+    j.uses = mem_alloc(slots * sizeof(int));
+    j.read = mem_alloc(slots * sizeof(bool));
+    j.reg = mem_alloc(slots * sizeof(int));
+    for(int i = 0; i < slots; i++) {
+        j.uses[i] = 0;
+        j.read[i] = false;
+    }
+    if(!scan_line(&j, line)) goto done;
+
+    assign_regs(&j);
+    gen_function(&j, line);
+    void* mem = mmap(NULL, j.len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mem == MAP_FAILED) goto done;
+    memcpy(mem, j.buf, j.len);
+    if(mprotect(mem, j.len, PROT_READ | PROT_EXEC) < 0) {
+        munmap(mem, j.len);
+        goto done;
+    }
+    code->mem = mem;
+    code->size = j.len;
+    code->fn = (long (*)(long*, bool*, long, Stats*, Shadow*))(uintptr_t)mem;
+    code->reads = mem_alloc(slots * sizeof(int));
+    for(int i = 0; i < slots; i++) {
+        if(j.read[i]) code->reads[code->reads_len++] = i;
+    }
+done:
+    free(j.uses);
+    free(j.read);
+    free(j.reg);
+    free(j.colds);
+    free(j.buf);
+}
+
+JitCode* jit_get(Ast* ast, Line* line, int slots, long depth) {
+    pthread_mutex_lock(&cache_lock);
+    JitCode* code;
+    for(code = cache; code != NULL; code = code->next) {
+        if(code->line == line) break;
+    }
+    if(code == NULL) {
+        code = mem_alloc(sizeof(JitCode));
+        *code = (JitCode){
+            .line = line, .fn = NULL, .mem = NULL, .size = 0,
+            .reads_len = 0, .reads = NULL, .next = cache,
+        };
+        cache = code;
+        compile_loop(code, ast, line, slots, depth);
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return code->fn ? code : NULL;
+}
+
+bool jit_run(JitCode* code, Vars* vars, long* result) {
+    for(int i = 0; i < code->reads_len; i++) {
+        if(!vars->set[code->reads[i]]) return false;
+    }
+    vars->set[SLOT_LAST] = true;
+    *result = code->fn(vars->values, vars->set, *result, &stats, &shadow);
+    return true;
+}
+
+void jit_flush(void) {
+    while(cache != NULL) {
+        JitCode* next = cache->next;
+        if(cache->mem != NULL) munmap(cache->mem, cache->size);
+        free(cache->reads);
+        free(cache);
+        cache = next;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include "eval.h"
+#include "parser.h"
+
+// Native code for hot .while loops. Both evaluators count iterations
+// and, once a loop has run JIT_THRESHOLD of them, hand the rest of it to
+// machine code compiled straight from the tree. Loops using anything the
+// JIT does not handle are remembered and stay interpreted.
+#define JIT_THRESHOLD 64
+
+typedef struct JitCode JitCode;
+
+// Set to false to always interpret.
+extern bool jit_enabled;
+
+// Returns the compiled form of a .while line, compiling it on first
+// use, or NULL if the loop cannot be compiled. slots is the number of
+// variables the script uses, and depth how many blocks the line is
+// inside, counted from the start of its line or task.
+JitCode* jit_get(Ast* ast, Line* line, int slots, long depth);
+
+// Runs the rest of a loop natively, starting with its condition. result
+// holds the loop's value so far and receives its final value. Returns
+// false without running anything if a variable the loop reads is unset,
+// in which case the interpreter carries on.
+bool jit_run(JitCode* code, Vars* vars, long* result);
+
+// Releases all compiled code. Must be called before the ast the code
+// was compiled from is reset or freed.
+void jit_flush(void);
@@ -0,0 +1,122 @@
+#include <stdbool.h>
+
+#include "layout.h"
+
+typedef struct {
+    const char* next;
+    long repeat;
+    int width;
+    bool is_signed;
+    bool pad;
+} Field;
+
+// Advances f to the next field, returning false at the end of the
+// layout or, with f->width set to 0, at a malformed code.
+static bool next_field(Field* f) {
+    if(f->repeat > 1) {
+        f->repeat--;
+        return true;
+    }
+    while(*f->next == ' ') f->next++;
+    if(*f->next == '\0') return false;
+    long repeat = 0;
+    bool counted = false;
+    while(*f->next >= '0' && *f->next <= '9') {
+        repeat = repeat * 10 + (*f->next++ - '0');
+        counted = true;
+        if(repeat > 1 << 20) break;
+    }
+    f->repeat = counted ? repeat : 1;
+    f->pad = false;
+    switch(*f->next++) {
+        case 'b': f->width = 1; f->is_signed = true; break;
+        case 'B': f->width = 1; f->is_signed = false; break;
+        case 'h': f->width = 2; f->is_signed = true; break;
+        case 'H': f->width = 2; f->is_signed = false; break;
+        case 'i': f->width = 4; f->is_signed = true; break;
+        case 'I': f->width = 4; f->is_signed = false; break;
+        case 'q': f->width = 8; f->is_signed = true; break;
+        case 'Q': f->width = 8; f->is_signed = false; break;
+        case 'x': f->width = 1; f->pad = true; break;
+        default:  f->width = 0; return false;
+    }
+    // "0q" is as malformed as a count with no code after it.
+    if(f->repeat == 0 || f->repeat > 1 << 20) {
+        f->width = 0;
+        return false;
+    }
+    return true;
+}
+
+// Fields layout_pack places before it writes any, so a bad layout or
+// count leaves dst untouched. Longer layouts are parsed a second time.
+#define PACK_FIELDS 16
+
+long layout_pack(void* dst, const char* layout, const long* vals, int n) {
+    struct {
+        long offset;
+        int width;
+    } placed[PACK_FIELDS];
+    Field f = {.next = layout, .repeat = 0};
+    long offset = 0;
+    int fields = 0;
+    while(next_field(&f)) {
+        if(f.pad) {
+            offset++;
+            continue;
+        }
+        if(fields == n) return -1;
+        offset = (offset + f.width - 1) & ~(long)(f.width - 1);
+        if(fields < PACK_FIELDS) {
+            placed[fields].offset = offset;
+            placed[fields].width = f.width;
+        }
+        fields++;
+        offset += f.width;
+    }
+    if(f.width == 0 || fields != n) return -1;
+    long size = offset;
+
+    if(n <= PACK_FIELDS) {
+        for(int i = 0; i < n; i++) layout_store((char*)dst + placed[i].offset, placed[i].width, vals[i]);
+        return size;
+    }
+    f = (Field){.next = layout, .repeat = 0};
+    offset = 0;
+    while(next_field(&f)) {
+        if(f.pad) {
+            offset++;
+            continue;
+        }
+        offset = (offset + f.width - 1) & ~(long)(f.width - 1);
+        layout_store((char*)dst + offset, f.width, *vals++);
+        offset += f.width;
+    }
+    return size;
+}
+
+long layout_unpack(const void* src, const char* layout, long* vals, int n) {
+    Field f = {.next = layout, .repeat = 0};
+    long offset = 0;
+    int fields = 0;
+    while(next_field(&f)) {
+        if(f.pad) {
+            offset++;
+            continue;
+        }
+        if(fields++ == n) return -1;
+        offset = (offset + f.width - 1) & ~(long)(f.width - 1);
+        long v = layout_load((const char*)src + offset, f.width);
+        if(f.is_signed) {
+            switch(f.width) {
+                case 1: v = (int8_t)v; break;
+                case 2: v = (int16_t)v; break;
+                case 4: v = (int32_t)v; break;
+            }
+        }
+        *vals++ = v;
+        offset += f.width;
+    }
+    if(f.width == 0 || fields != n) return -1;
+    return offset;
+}
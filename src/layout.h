@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Typed memory access for .loadN/.storeN, and struct layouts for .pack
+// and .unpack.
+//
+// A layout is a string of field codes, one per value: b, h, i and q for
+// signed 8, 16, 32 and 64-bit integers, B, H, I and Q for unsigned
+// ones, and x for a byte of padding that takes no value. A code may be
+// preceded by a count, so "2q" is "qq" and "4x" skips four bytes. Each
+// field is aligned to its size as in a C struct on x86-64, so a
+// timespec is "qq" and an iovec "QQ". Spaces are ignored.
+
+// Loads width bytes from addr, zero-extended. addr need not be aligned.
+static inline long layout_load(const void* addr, int width) {
+    switch(width) {
+        case 1: { uint8_t v; memcpy(&v, addr, 1); return v; }
+        case 2: { uint16_t v; memcpy(&v, addr, 2); return v; }
+        case 4: { uint32_t v; memcpy(&v, addr, 4); return v; }
+        default: { int64_t v; memcpy(&v, addr, 8); return v; }
+    }
+}
+
+// Stores the low width bytes of value at addr.
+static inline void layout_store(void* addr, int width, long value) {
+    switch(width) {
+        case 1: { uint8_t v = value; memcpy(addr, &v, 1); break; }
+        case 2: { uint16_t v = value; memcpy(addr, &v, 2); break; }
+        case 4: { uint32_t v = value; memcpy(addr, &v, 4); break; }
+        default: { int64_t v = value; memcpy(addr, &v, 8); break; }
+    }
+}
+
+// Writes the n values in vals to dst as layout describes. Returns the
+// offset just past the last field, or -1 without writing anything if
+// layout is malformed or does not have exactly n fields.
+long layout_pack(void* dst, const char* layout, const long* vals, int n);
+
+// Reads the n fields layout describes from src into vals. Returns as
+// layout_pack does, though vals may have been written either way.
+long layout_unpack(const void* src, const char* layout, long* vals, int n);
+
+// .unpack reads up to this many fields into an array on the stack, and
+// more into one on the heap.
+#define UNPACK_INLINE 16
@@ -1,76 +1,329 @@
 #include <errno.h>
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "batch.h"
+#include "buf.h"
+#include "cache.h"
+#include "coalesce.h"
 #include "eval.h"
-#include "hashmap.h"
+#include "heap.h"
+#include "jit.h"
+#include "mem.h"
+#include "optimize.h"
 #include "parser.h"
+#include "profile.h"
 #include "scanner.h"
+#include "stats.h"
+#include "task.h"
+#include "trace.h"
+#include "compiler.h"
+#include "vdso.h"
+#include "vm.h"
 
-#define LINE_LEN 1024
+#define STREAM_CHUNK (64 * 1024)
 #define PROMPT "[%ld]sysh$ "
 #define EPROMPT "[E]sysh$ "
+#define CPROMPT "...sysh$ "
 
-static long repl() {
-    char buf[LINE_LEN];
-    printf(PROMPT, 0L);
-    Hashmap vars;
-    hashmap_init(&vars);
-    while(fgets(buf, LINE_LEN, stdin)) {
-        Scanner sc = init_scanner(buf);
-        BlockResult br = parse(&sc);
-        if(!br.is_ok) {
-            printf("sysh: %s\n", br.as.err);
-            printf(EPROMPT);
-        } else if(br.as.ok.len > 0) {
-            long result = eval_block(&br.as.ok, &vars);
-            printf(PROMPT, result);
-            block_free(&br.as.ok);
+static bool tree_walk = false;
+static bool alloc_stats = false;
+static bool no_opt = false;
+static bool dump_opt = false;
+static bool no_vdso = false;
+static bool use_cache = false;
+static bool compile_only = false;
+static const char* profile_path = NULL;
+
+static long run_block(Ast* ast, Block block, Vars* vars) {
+    shadow.ast = ast;
+    if(tree_walk) return eval_run(ast, block, vars);
+    Program prog;
+    program_init(&prog);
+    compile(ast, block, &prog);
+    long result = vm_run(&prog, vars);
+    program_free(&prog);
+    return result;
+}
+
+// Runs the optimizer over a parsed block, which must not be sealed yet.
+static Block prepare(Ast* ast, Block block, Symbols* syms, bool whole_script) {
+    if(!no_opt) block = optimize(ast, block, syms->len, whole_script);
+    if(dump_opt) ast_dump(stderr, ast, block, syms);
+    return block;
+}
+
+static void prompt(const char* format, long result) {
+    coalesce_flush();
+    printf(format, result);
+    fflush(stdout);
+}
+
+// Reads a script from fd in large chunks and runs each complete top-level
+// line as soon as it has been read. Only the line currently being read
+// is kept, so memory stays bounded however long the input is. The lines
+// completed by one read are parsed into a shared arena, which is sealed
+// once before they run.
+static long run_stream(int fd) {
+    bool interactive = isatty(fd);
+    errno = 0;
+    size_t capacity = STREAM_CHUNK;
+    char* buf = mem_alloc(capacity);
+    size_t len = 0;
+    size_t scanned = 0;
+    Frame frame = {.depth = 0, .quote = 0, .escape = false, .comment = false, .rows = 0};
+    int row = 1;
+    int lines_capacity = 0;
+    BlockResult* lines = NULL;
+
+    Symbols syms;
+    symbols_init(&syms);
+    Vars vars;
+    vars_init(&vars);
+    Ast ast;
+    ast_init(&ast);
+
+    if(interactive) prompt(PROMPT, 0);
+    bool eof = false;
+    while(!eof) {
+        // Whatever the lines so far wrote is seen before waiting for more.
+        coalesce_flush();
+        ssize_t n = read(fd, buf + len, capacity - len);
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0) {
+            eof = true;
+        } else {
+            len += n;
+        }
+
+        int count = 0;
+        size_t start = 0;
+        long end;
+        while(start < len) {
+            end = scanner_frame(&frame, buf + scanned, len - scanned);
+            if(end < 0 && !eof) break;
+            scanned = (end < 0) ? len : scanned + end;
+            if(lines_capacity <= count) {
+                lines_capacity = (lines_capacity == 0 ? 64 : 2*lines_capacity);
+                lines = mem_realloc(lines, lines_capacity * sizeof(BlockResult));
+            }
+            Scanner sc = init_scanner(buf + start, scanned - start);
+            sc.row = row;
+            row = frame.rows + 1;
+            BlockResult br = parse(&sc, &syms, &ast);
+            if(br.is_ok) br.as.ok = prepare(&ast, br.as.ok, &syms, false);
+            lines[count++] = br;
+            start = scanned;
+        }
+        scanned = len;
+
+        if(count > 0) {
+            ast_seal(&ast);
+            vars_resize(&vars, syms.len);
+            for(int i = 0; i < count; i++) {
+                BlockResult br = lines[i];
+                if(!br.is_ok) {
+                    printf("sysh: %s\n", br.as.err);
+                    if(interactive) prompt(EPROMPT, 0);
+                    continue;
+                }
+                long result = 0;
+                if(br.as.ok.len > 0) result = run_block(&ast, br.as.ok, &vars);
+                if(interactive) prompt(PROMPT, result);
+            }
+            // Finished tasks stay joinable from later lines, but none may
+            // still be running the lines about to be freed.
+            task_wait_all();
+            jit_flush();
+            profile_flush();
+            ast_reset(&ast);
+        }
+
+        memmove(buf, buf + start, len - start);
+        len -= start;
+        scanned -= start;
+        if(len == capacity) {
+            capacity *= 2;
+            buf = mem_realloc(buf, capacity);
         }
+        if(interactive && len > 0 && !eof) prompt(CPROMPT, 0);
     }
-    hashmap_free(&vars);
+    free(lines);
+    free(buf);
+    task_wait_all();
+    jit_flush();
+    ast_free(&ast);
+    vars_free(&vars);
+    symbols_free(&syms);
     return 0;
 }
 
-static long run_file(const char* name) {
-    FILE* file = fopen(name, "r");
-    if(file == NULL) {
+// Runs a whole script from a sealed or sealable tree.
+static void run_program(Ast* ast, Block block, int slots) {
+    Vars vars;
+    vars_init(&vars);
+    ast_seal(ast);
+    vars_resize(&vars, slots);
+    errno = 0;
+    if(block.len > 0) run_block(ast, block, &vars);
+    task_wait_all();
+    vars_free(&vars);
+    jit_flush();
+    profile_flush();
+}
+
+// Parses the script in name and runs it, unless run is false. If image
+// is not NULL, the parsed script is also written there.
+static long compile_file(const char* name, const char* image, bool run) {
+    int fd = open(name, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) < 0) {
         fprintf(stderr, "%s\n", strerror(errno));
+        if(fd >= 0) close(fd);
         return 1;
     }
-    fseek(file, 0, SEEK_END);
-    long fsize = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    char* buf = malloc(fsize + 1);
-    fread(buf, fsize, 1, file);
-    fclose(file);
-
-    buf[fsize] = '\0';
+    // The scanner hands out slices into this mapping, so the file is
+    // never copied. An empty file cannot be mapped and needs no buffer.
+    size_t fsize = st.st_size;
+    const char* buf = "";
+    if(fsize > 0) {
+        buf = mmap(NULL, fsize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(buf == MAP_FAILED) {
+            fprintf(stderr, "%s\n", strerror(errno));
+            close(fd);
+            return 1;
+        }
+    }
+    close(fd);
 
-    Hashmap vars;
-    hashmap_init(&vars);
-    Scanner sc = init_scanner(buf);
-    BlockResult br = parse(&sc);
+    Symbols syms;
+    symbols_init(&syms);
+    Ast ast;
+    ast_init(&ast);
+    Scanner sc = init_scanner(buf, fsize);
+    sc.name = name;
+    BlockResult br = parse(&sc, &syms, &ast);
     if(!br.is_ok) {
         printf("sysh: %s\n", br.as.err);
-    } else if(br.as.ok.len > 0) {
-        eval_block(&br.as.ok, &vars);
-        block_free(&br.as.ok);
+    } else {
+        Block block = br.as.ok;
+        if(block.len > 0) block = prepare(&ast, block, &syms, true);
+        if(image != NULL) {
+            Cached prog = {.root = block, .slots = syms.len};
+            if(!cache_store(image, name, buf, fsize, &ast, prog)) {
+                fprintf(stderr, "sysh: cannot write %s: %s\n", image, strerror(errno));
+            }
+        }
+        if(run) run_program(&ast, block, syms.len);
     }
-    hashmap_free(&vars);
-    free(buf);
+    symbols_free(&syms);
+    ast_free(&ast);
+    if(fsize > 0) munmap((void*)buf, fsize);
 
     return 0;
 }
 
+// Runs image if it is fresh for source, and otherwise rebuilds it from
+// source first.
+static long run_cached(const char* image, const char* source) {
+    Ast ast;
+    ast_init(&ast);
+    Cached prog;
+    if(cache_load(image, source, &ast, &prog) != CACHE_OK) return compile_file(source, image, true);
+    run_program(&ast, prog.root, prog.slots);
+    ast_free(&ast);
+    return 0;
+}
+
+// An image can be run in place of its script. Images only hold the
+// optimized tree, so --no-opt and --dump-opt go back to the script.
+static long run_file(const char* name) {
+    bool cacheable = !no_opt && !dump_opt;
+    char* source = cache_source(name);
+    long result;
+    if(source != NULL) {
+        result = cacheable ? run_cached(name, source) : compile_file(source, NULL, true);
+    } else if(use_cache && cacheable) {
+        char* image = cache_path(name);
+        result = run_cached(image, name);
+        free(image);
+    } else {
+        result = compile_file(name, NULL, true);
+    }
+    free(source);
+    return result;
+}
+
 int main(int argc, const char** argv) {
     if(argc < 1) return 1;
-    if(argc == 1) return repl();
-    if(argc == 2) return run_file(argv[1]);
-    fprintf(stderr, "usage: %s [file]\n", argv[0]);
-    return 1;
+    const char* file = NULL;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--tree-walk") == 0) {
+            tree_walk = true;
+        } else if(strcmp(argv[i], "--alloc-stats") == 0) {
+            alloc_stats = true;
+        } else if(strcmp(argv[i], "--no-uring") == 0) {
+            batch_uring = false;
+        } else if(strcmp(argv[i], "--no-vdso") == 0) {
+            no_vdso = true;
+        } else if(strcmp(argv[i], "--no-jit") == 0) {
+            jit_enabled = false;
+        } else if(strcmp(argv[i], "--no-opt") == 0) {
+            no_opt = true;
+        } else if(strcmp(argv[i], "--dump-opt") == 0) {
+            dump_opt = true;
+        } else if(strcmp(argv[i], "--cache") == 0) {
+            use_cache = true;
+        } else if(strcmp(argv[i], "--compile") == 0) {
+            compile_only = true;
+        } else if(strcmp(argv[i], "--coalesce") == 0) {
+            coalesce_enabled = true;
+        } else if(strcmp(argv[i], "--trace-summary") == 0) {
+            trace_enabled = true;
+        } else if(strncmp(argv[i], "--profile=", 10) == 0 && argv[i][10] != '\0') {
+            profile_path = argv[i] + 10;
+        } else if(file == NULL && argv[i][0] != '-') {
+            file = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [--tree-walk] [--alloc-stats] [--no-uring] [--trace-summary] [--coalesce] [--no-opt] [--dump-opt] [--no-jit] [--no-vdso] [--cache] [--compile] [--profile=out.folded] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(compile_only) {
+        if(file == NULL) {
+            fprintf(stderr, "%s: --compile needs a file\n", argv[0]);
+            return 1;
+        }
+        char* image = cache_path(file);
+        long result = compile_file(file, image, false);
+        free(image);
+        return result;
+    }
+    if(profile_path != NULL && !profile_start(profile_path)) {
+        fprintf(stderr, "sysh: cannot write %s: %s\n", profile_path, strerror(errno));
+        return 1;
+    }
+    stats_thread_start();
+    if(!no_vdso) vdso_init();
+    buf_init();
+    task_runner = run_block;
+    long result = (file == NULL) ? run_stream(STDIN_FILENO) : run_file(file);
+    task_shutdown();
+    coalesce_flush();
+    profile_stop();
+    heap_report(stderr);
+    if(alloc_stats) {
+        fprintf(stderr, "sysh: %ld interpreter allocations\n", mem_allocs);
+    }
+    if(trace_enabled) trace_summary(stderr);
+    const char* dump_stats = getenv("SYSH_STATS");
+    if(dump_stats != NULL && strcmp(dump_stats, "1") == 0) stats_dump(stderr);
+    return result;
 }
@@ -0,0 +1,21 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem.h"
+
+long mem_allocs = 0;
+
+void* mem_alloc(size_t size) {
+    __atomic_fetch_add(&mem_allocs, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+void* mem_realloc(void* ptr, size_t size) {
+    __atomic_fetch_add(&mem_allocs, 1, __ATOMIC_RELAXED);
+    return realloc(ptr, size);
+}
+
+char* mem_strdup(const char* str) {
+    __atomic_fetch_add(&mem_allocs, 1, __ATOMIC_RELAXED);
+    return strdup(str);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+
+// Allocation wrappers for the interpreter's own bookkeeping (tokens, the
+// tree, bytecode). Memory owned by scripts comes from heap.h instead.
+// Every call bumps mem_allocs so the cost of each stage can be measured
+// with --alloc-stats. The count is updated atomically, as tasks allocate
+// from several threads.
+extern long mem_allocs;
+
+void* mem_alloc(size_t size);
+void* mem_realloc(void* ptr, size_t size);
+char* mem_strdup(const char* str);
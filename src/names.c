@@ -0,0 +1,431 @@
+#include <stddef.h>
+#include "names.h"
+#include "trie.h"
+
+/* auto-generated by namegen.py */
+
+const char* const syscall_names[SYSCALL_COUNT] = {
+  "read",
+  "write",
+  "open",
+  "close",
+  "stat",
+  "fstat",
+  "lstat",
+  "poll",
+  "lseek",
+  "mmap",
+  "mprotect",
+  "munmap",
+  "brk",
+  "rt_sigaction",
+  "rt_sigprocmask",
+  "rt_sigreturn",
+  "ioctl",
+  "pread64",
+  "pwrite64",
+  "readv",
+  "writev",
+  "access",
+  "pipe",
+  "select",
+  "sched_yield",
+  "mremap",
+  "msync",
+  "mincore",
+  "madvise",
+  "shmget",
+  "shmat",
+  "shmctl",
+  "dup",
+  "dup2",
+  "pause",
+  "nanosleep",
+  "getitimer",
+  "alarm",
+  "setitimer",
+  "getpid",
+  "sendfile",
+  "socket",
+  "connect",
+  "accept",
+  "sendto",
+  "recvfrom",
+  "sendmsg",
+  "recvmsg",
+  "shutdown",
+  "bind",
+  "listen",
+  "getsockname",
+  "getpeername",
+  "socketpair",
+  "setsockopt",
+  "getsockopt",
+  "clone",
+  "fork",
+  "vfork",
+  "execve",
+  "exit",
+  "wait4",
+  "kill",
+  "uname",
+  "semget",
+  "semop",
+  "semctl",
+  "shmdt",
+  "msgget",
+  "msgsnd",
+  "msgrcv",
+  "msgctl",
+  "fcntl",
+  "flock",
+  "fsync",
+  "fdatasync",
+  "truncate",
+  "ftruncate",
+  "getdents",
+  "getcwd",
+  "chdir",
+  "fchdir",
+  "rename",
+  "mkdir",
+  "rmdir",
+  "creat",
+  "link",
+  "unlink",
+  "symlink",
+  "readlink",
+  "chmod",
+  "fchmod",
+  "chown",
+  "fchown",
+  "lchown",
+  "umask",
+  "gettimeofday",
+  "getrlimit",
+  "getrusage",
+  "sysinfo",
+  "times",
+  "ptrace",
+  "getuid",
+  "syslog",
+  "getgid",
+  "setuid",
+  "setgid",
+  "geteuid",
+  "getegid",
+  "setpgid",
+  "getppid",
+  "getpgrp",
+  "setsid",
+  "setreuid",
+  "setregid",
+  "getgroups",
+  "setgroups",
+  "setresuid",
+  "getresuid",
+  "setresgid",
+  "getresgid",
+  "getpgid",
+  "setfsuid",
+  "setfsgid",
+  "getsid",
+  "capget",
+  "capset",
+  "rt_sigpending",
+  "rt_sigtimedwait",
+  "rt_sigqueueinfo",
+  "rt_sigsuspend",
+  "sigaltstack",
+  "utime",
+  "mknod",
+  "uselib",
+  "personality",
+  "ustat",
+  "statfs",
+  "fstatfs",
+  "sysfs",
+  "getpriority",
+  "setpriority",
+  "sched_setparam",
+  "sched_getparam",
+  "sched_setscheduler",
+  "sched_getscheduler",
+  "sched_get_priority_max",
+  "sched_get_priority_min",
+  "sched_rr_get_interval",
+  "mlock",
+  "munlock",
+  "mlockall",
+  "munlockall",
+  "vhangup",
+  "modify_ldt",
+  "pivot_root",
+  "_sysctl",
+  "prctl",
+  "arch_prctl",
+  "adjtimex",
+  "setrlimit",
+  "chroot",
+  "sync",
+  "acct",
+  "settimeofday",
+  "mount",
+  "umount2",
+  "swapon",
+  "swapoff",
+  "reboot",
+  "sethostname",
+  "setdomainname",
+  "iopl",
+  "ioperm",
+  "create_module",
+  "init_module",
+  "delete_module",
+  "get_kernel_syms",
+  "query_module",
+  "quotactl",
+  "nfsservctl",
+  "getpmsg",
+  "putpmsg",
+  "afs_syscall",
+  "tuxcall",
+  "security",
+  "gettid",
+  "readahead",
+  "setxattr",
+  "lsetxattr",
+  "fsetxattr",
+  "getxattr",
+  "lgetxattr",
+  "fgetxattr",
+  "listxattr",
+  "llistxattr",
+  "flistxattr",
+  "removexattr",
+  "lremovexattr",
+  "fremovexattr",
+  "tkill",
+  "time",
+  "futex",
+  "sched_setaffinity",
+  "sched_getaffinity",
+  "set_thread_area",
+  "io_setup",
+  "io_destroy",
+  "io_getevents",
+  "io_submit",
+  "io_cancel",
+  "get_thread_area",
+  "lookup_dcookie",
+  "epoll_create",
+  "epoll_ctl_old",
+  "epoll_wait_old",
+  "remap_file_pages",
+  "getdents64",
+  "set_tid_address",
+  "restart_syscall",
+  "semtimedop",
+  "fadvise64",
+  "timer_create",
+  "timer_settime",
+  "timer_gettime",
+  "timer_getoverrun",
+  "timer_delete",
+  "clock_settime",
+  "clock_gettime",
+  "clock_getres",
+  "clock_nanosleep",
+  "exit_group",
+  "epoll_wait",
+  "epoll_ctl",
+  "tgkill",
+  "utimes",
+  "vserver",
+  "mbind",
+  "set_mempolicy",
+  "get_mempolicy",
+  "mq_open",
+  "mq_unlink",
+  "mq_timedsend",
+  "mq_timedreceive",
+  "mq_notify",
+  "mq_getsetattr",
+  "kexec_load",
+  "waitid",
+  "add_key",
+  "request_key",
+  "keyctl",
+  "ioprio_set",
+  "ioprio_get",
+  "inotify_init",
+  "inotify_add_watch",
+  "inotify_rm_watch",
+  "migrate_pages",
+  "openat",
+  "mkdirat",
+  "mknodat",
+  "fchownat",
+  "futimesat",
+  "newfstatat",
+  "unlinkat",
+  "renameat",
+  "linkat",
+  "symlinkat",
+  "readlinkat",
+  "fchmodat",
+  "faccessat",
+  "pselect6",
+  "ppoll",
+  "unshare",
+  "set_robust_list",
+  "get_robust_list",
+  "splice",
+  "tee",
+  "sync_file_range",
+  "vmsplice",
+  "move_pages",
+  "utimensat",
+  "epoll_pwait",
+  "signalfd",
+  "timerfd_create",
+  "eventfd",
+  "fallocate",
+  "timerfd_settime",
+  "timerfd_gettime",
+  "accept4",
+  "signalfd4",
+  "eventfd2",
+  "epoll_create1",
+  "dup3",
+  "pipe2",
+  "inotify_init1",
+  "preadv",
+  "pwritev",
+  "rt_tgsigqueueinfo",
+  "perf_event_open",
+  "recvmmsg",
+  "fanotify_init",
+  "fanotify_mark",
+  "prlimit64",
+  "name_to_handle_at",
+  "open_by_handle_at",
+  "clock_adjtime",
+  "syncfs",
+  "sendmmsg",
+  "setns",
+  "getcpu",
+  "process_vm_readv",
+  "process_vm_writev",
+  "kcmp",
+  "finit_module",
+  "sched_setattr",
+  "sched_getattr",
+  "renameat2",
+  "seccomp",
+  "getrandom",
+  "memfd_create",
+  "kexec_file_load",
+  "bpf",
+  "execveat",
+  "userfaultfd",
+  "membarrier",
+  "mlock2",
+  "copy_file_range",
+  "preadv2",
+  "pwritev2",
+  "pkey_mprotect",
+  "pkey_alloc",
+  "pkey_free",
+  "statx",
+};
+
+const unsigned char syscall_min_args[SYSCALL_COUNT] = {
+  3, 3, 2, 1, 2, 2, 2, 3, 3, 6, 3, 2, 1, 4, 4, 0,
+  2, 4, 4, 3, 3, 2, 1, 5, 0, 4, 3, 3, 3, 3, 3, 3,
+  1, 2, 0, 2, 2, 1, 3, 0, 4, 3, 3, 3, 6, 6, 3, 3,
+  2, 3, 2, 3, 3, 4, 5, 5, 1, 0, 0, 3, 1, 4, 2, 1,
+  3, 3, 3, 1, 2, 4, 5, 3, 2, 2, 1, 1, 2, 2, 3, 2,
+  1, 1, 2, 2, 1, 2, 2, 1, 2, 3, 2, 2, 3, 3, 3, 1,
+  2, 2, 2, 1, 1, 1, 0, 1, 0, 1, 1, 0, 0, 2, 0, 0,
+  0, 2, 2, 2, 2, 3, 3, 3, 3, 1, 1, 1, 1, 2, 2, 2,
+  4, 3, 2, 2, 2, 3, 1, 1, 2, 2, 2, 1, 2, 3, 2, 2,
+  3, 1, 1, 1, 2, 2, 2, 1, 0, 0, 3, 2, 1, 1, 2, 1,
+  2, 1, 0, 1, 2, 5, 2, 2, 1, 3, 2, 2, 1, 3, 0, 3,
+  2, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 3, 5, 5, 5, 4,
+  4, 4, 3, 3, 3, 2, 2, 2, 2, 1, 2, 3, 3, 1, 2, 1,
+  5, 3, 3, 1, 3, 1, 0, 0, 5, 3, 1, 0, 4, 4, 3, 4,
+  2, 1, 1, 2, 2, 2, 4, 1, 4, 4, 3, 2, 0, 6, 3, 5,
+  2, 1, 5, 5, 2, 3, 4, 4, 5, 4, 1, 3, 2, 0, 3, 2,
+  4, 3, 3, 4, 5, 3, 4, 3, 4, 5, 3, 4, 3, 3, 6, 5,
+  1, 2, 3, 6, 4, 4, 4, 6, 4, 6, 3, 2, 1, 4, 4, 2,
+  4, 4, 2, 1, 3, 2, 1, 5, 5, 4, 5, 5, 2, 5, 4, 5,
+  3, 2, 1, 4, 2, 3, 6, 6, 5, 3, 3, 4, 5, 3, 3, 2,
+  5, 3, 5, 1, 2, 3, 6, 6, 6, 4, 2, 1, 5,
+};
+
+const unsigned char syscall_args[SYSCALL_COUNT] = {
+  3, 3, 3, 1, 2, 2, 2, 3, 3, 6, 3, 2, 1, 4, 4, 0,
+  3, 4, 4, 3, 3, 2, 1, 5, 0, 5, 3, 3, 3, 3, 3, 3,
+  1, 2, 0, 2, 2, 1, 3, 0, 4, 3, 3, 3, 6, 6, 3, 3,
+  2, 3, 2, 3, 3, 4, 5, 5, 5, 0, 0, 3, 1, 4, 2, 1,
+  3, 3, 4, 1, 2, 4, 5, 3, 3, 2, 1, 1, 2, 2, 3, 2,
+  1, 1, 2, 2, 1, 2, 2, 1, 2, 3, 2, 2, 3, 3, 3, 1,
+  2, 2, 2, 1, 1, 4, 0, 3, 0, 1, 1, 0, 0, 2, 0, 0,
+  0, 2, 2, 2, 2, 3, 3, 3, 3, 1, 1, 1, 1, 2, 2, 2,
+  4, 3, 2, 2, 2, 3, 1, 1, 2, 2, 2, 3, 2, 3, 2, 2,
+  3, 1, 1, 1, 2, 2, 2, 1, 0, 0, 3, 2, 1, 5, 2, 1,
+  2, 1, 0, 1, 2, 5, 2, 2, 1, 4, 2, 2, 1, 3, 6, 3,
+  2, 6, 6, 4, 6, 6, 6, 6, 6, 6, 0, 3, 5, 5, 5, 4,
+  4, 4, 3, 3, 3, 2, 2, 2, 2, 1, 6, 3, 3, 1, 2, 1,
+  5, 3, 3, 1, 3, 1, 6, 6, 5, 3, 1, 0, 4, 4, 3, 4,
+  2, 1, 1, 2, 2, 2, 4, 1, 4, 4, 3, 2, 6, 6, 3, 5,
+  4, 1, 5, 5, 2, 3, 4, 5, 5, 4, 5, 3, 2, 0, 3, 2,
+  4, 4, 3, 4, 5, 3, 4, 3, 4, 5, 3, 4, 3, 3, 6, 5,
+  1, 2, 3, 6, 4, 4, 4, 6, 4, 6, 3, 2, 1, 4, 4, 2,
+  4, 4, 2, 1, 3, 2, 1, 5, 5, 4, 5, 5, 2, 5, 4, 5,
+  3, 2, 1, 4, 2, 3, 6, 6, 5, 3, 3, 4, 5, 3, 3, 2,
+  5, 3, 5, 1, 3, 3, 6, 6, 6, 4, 2, 1, 5,
+};
+
+_Static_assert(333 == SYSCALL_COUNT, "SYSCALL_COUNT out of date");
+
+const char* name_of(long id) {
+  if(id >= 0) return id < SYSCALL_COUNT ? syscall_names[id] : NULL;
+  switch(id) {
+    case C_ALLOC: return ".alloc";
+    case C_REALLOC: return ".realloc";
+    case C_FREE: return ".free";
+    case C_SET: return ".set";
+    case C_CPY: return ".cpy";
+    case C_DEREF: return ".deref";
+    case C_IF: return ".if";
+    case C_WHILE: return ".while";
+    case C_ADD: return ".add";
+    case C_SUB: return ".sub";
+    case C_MUL: return ".mul";
+    case C_DIV: return ".div";
+    case C_BATCH: return ".batch";
+    case C_SPAWN: return ".spawn";
+    case C_JOIN: return ".join";
+    case C_FIND: return ".find";
+    case C_COUNT: return ".count";
+    case C_CMP: return ".cmp";
+    case C_FILL: return ".fill";
+    case C_MEMSTAT: return ".memstat";
+    case C_PUMP: return ".pump";
+    case C_STATS: return ".stats";
+    case C_PSPAWN: return ".pspawn";
+    case C_LOAD8: return ".load8";
+    case C_LOAD16: return ".load16";
+    case C_LOAD32: return ".load32";
+    case C_LOAD64: return ".load64";
+    case C_STORE8: return ".store8";
+    case C_STORE16: return ".store16";
+    case C_STORE32: return ".store32";
+    case C_STORE64: return ".store64";
+    case C_PACK: return ".pack";
+    case C_UNPACK: return ".unpack";
+    default: return NULL;
+  }
+}
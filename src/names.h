@@ -0,0 +1,14 @@
+#pragma once
+
+// Reverse of trie_get, generated from gen/commands and gen/syscalls_x86_64.
+#define SYSCALL_COUNT 333
+
+extern const char* const syscall_names[SYSCALL_COUNT];
+
+// How many arguments each syscall takes. Most take exactly
+// syscall_args; a few, like open's mode, may leave trailing ones out.
+extern const unsigned char syscall_min_args[SYSCALL_COUNT];
+extern const unsigned char syscall_args[SYSCALL_COUNT];
+
+// Name of a syscall or command id, or NULL if there is none.
+const char* name_of(long id);
@@ -0,0 +1,285 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "mem.h"
+#include "names.h"
+#include "optimize.h"
+#include "parser.h"
+#include "trie.h"
+
+// Growing the arena may move it, so lines are reached by block and index
+// rather than held as pointers across anything that allocates.
+typedef struct {
+    Ast* ast;
+    // Set while folding a top-level line that reads $LAST. Every block
+    // evaluation updates $LAST, so its blocks must then be kept.
+    bool keep_blocks;
+    bool propagate;
+    int* sets;
+    bool* known;
+    long* values;
+} Optimizer;
+
+static Line* line_at(Optimizer* o, Block block, int i) {
+    return ast_lines(o->ast, block) + i;
+}
+
+static void make_value(Line* line, Argument* args, long value) {
+    line->id = C_VALUE;
+    line->len = 1;
+    args[0] = (Argument){.type = ARG_NUM, .as.num = value};
+}
+
+static bool reads_last(Optimizer* o, Line* line) {
+    Argument* args = ast_args(o->ast, line);
+    for(int i = 0; i < line->len; i++) {
+        if(args[i].type == ARG_VAR && args[i].as.slot == SLOT_LAST) return true;
+        if(args[i].type != ARG_BLOCK) continue;
+        for(int j = 0; j < args[i].as.block.len; j++) {
+            if(reads_last(o, line_at(o, args[i].as.block, j))) return true;
+        }
+    }
+    return false;
+}
+
+static void count_sets(Optimizer* o, Block block) {
+    for(int i = 0; i < block.len; i++) {
+        Line* line = line_at(o, block, i);
+        Argument* args = ast_args(o->ast, line);
+        if(line->id == C_SET && line->len >= 1 && args[0].type == ARG_VAR) {
+            o->sets[args[0].as.slot]++;
+        }
+        // .unpack assigns every variable after its source and layout.
+        for(int j = 2; line->id == C_UNPACK && j < line->len; j++) {
+            if(args[j].type == ARG_VAR) o->sets[args[j].as.slot]++;
+        }
+        for(int j = 0; j < line->len; j++) {
+            if(args[j].type == ARG_BLOCK) count_sets(o, args[j].as.block);
+        }
+    }
+}
+
+static bool fold_op(int id, long a, long b, long* result) {
+    // Wrapping unsigned arithmetic matches what the evaluators do at run
+    // time without relying on signed overflow.
+    switch(id) {
+        case C_ADD: *result = (long)((unsigned long)a + (unsigned long)b); return true;
+        case C_SUB: *result = (long)((unsigned long)a - (unsigned long)b); return true;
+        case C_MUL: *result = (long)((unsigned long)a * (unsigned long)b); return true;
+        case C_DIV:
+            // Division by zero is left to fail at run time.
+            if(b == 0 || (a == LONG_MIN && b == -1)) return false;
+            *result = a / b;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static Block fold_block(Optimizer* o, Block block, bool top);
+
+// Folds line i of block. If the whole line reduces to a non-empty block
+// of other lines, returns true and stores it in splice.
+static bool fold_line(Optimizer* o, Block block, int i, Block* splice) {
+    // A .batch only accepts syscall lines, so folding inside one could
+    // turn a script error into a valid batch.
+    if(line_at(o, block, i)->id == C_BATCH) return false;
+    int len = line_at(o, block, i)->len;
+    for(int j = 0; j < len; j++) {
+        Argument* arg = &ast_args(o->ast, line_at(o, block, i))[j];
+        if(arg->type == ARG_VAR && o->propagate && o->known[arg->as.slot]) {
+            *arg = (Argument){.type = ARG_NUM, .as.num = o->values[arg->as.slot]};
+        }
+        if(arg->type != ARG_BLOCK) continue;
+        Block folded = fold_block(o, arg->as.block, false);
+        arg = &ast_args(o->ast, line_at(o, block, i))[j];
+        arg->as.block = folded;
+        // A .spawn needs its block even when it folds to a constant.
+        if(!o->keep_blocks && folded.len == 1 && line_at(o, block, i)->id != C_SPAWN) {
+            Line* only = line_at(o, folded, 0);
+            if(only->id == C_VALUE) {
+                *arg = (Argument){.type = ARG_NUM, .as.num = ast_args(o->ast, only)[0].as.num};
+            }
+        }
+    }
+
+    Line* line = line_at(o, block, i);
+    Argument* args = ast_args(o->ast, line);
+    long value;
+    switch(line->id) {
+        case C_ADD:
+        case C_SUB:
+        case C_MUL:
+        case C_DIV:
+            if(line->len == 2 && args[0].type == ARG_NUM && args[1].type == ARG_NUM
+                    && fold_op(line->id, args[0].as.num, args[1].as.num, &value)) {
+                make_value(line, args, value);
+            }
+            return false;
+        case C_WHILE:
+            if(line->len == 2 && args[0].type == ARG_NUM && args[0].as.num == 0) {
+                make_value(line, args, 0);
+            }
+            return false;
+        case C_IF: {
+            if(line->len < 2 || line->len > 3 || args[0].type != ARG_NUM) return false;
+            int taken = args[0].as.num ? 1 : 2;
+            if(taken >= line->len) {
+                make_value(line, args, 0);
+                return false;
+            }
+            Argument branch = args[taken];
+            if(branch.type == ARG_NUM) {
+                make_value(line, args, branch.as.num);
+            } else if(branch.type == ARG_BLOCK && branch.as.block.len == 0) {
+                make_value(line, args, 0);
+            } else if(branch.type == ARG_BLOCK) {
+                // The branch's lines leave $LAST and the result exactly as
+                // the .if around them would.
+                *splice = branch.as.block;
+                return true;
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+// Notes a top-level `.set $var <number>` as the only write to $var, so
+// every later read can use the number.
+static void learn(Optimizer* o, Line* line) {
+    Argument* args = ast_args(o->ast, line);
+    if(line->id != C_SET || line->len != 2) return;
+    if(args[0].type != ARG_VAR || args[1].type != ARG_NUM) return;
+    int slot = args[0].as.slot;
+    if(slot == SLOT_LAST || slot == SLOT_ERRNO || o->sets[slot] != 1) return;
+    o->known[slot] = true;
+    o->values[slot] = args[1].as.num;
+}
+
+static Block fold_block(Optimizer* o, Block block, bool top) {
+    int spliced = 0;
+    int splices_capacity = 0;
+    struct { int at; Block block; } *splices = NULL;
+    for(int i = 0; i < block.len; i++) {
+        if(top) o->keep_blocks = reads_last(o, line_at(o, block, i));
+        Block splice;
+        if(fold_line(o, block, i, &splice)) {
+            if(splices_capacity <= spliced) {
+                splices_capacity = (splices_capacity == 0 ? 8 : 2*splices_capacity);
+                splices = mem_realloc(splices, splices_capacity * sizeof(*splices));
+            }
+            splices[spliced].at = i;
+            splices[spliced++].block = splice;
+        } else if(top && o->propagate) {
+            learn(o, line_at(o, block, i));
+        }
+    }
+    if(spliced == 0) return block;
+
+    int len = block.len;
+    for(int i = 0; i < spliced; i++) len += splices[i].block.len - 1;
+    uint32_t lines = arena_alloc(&o->ast->arena, len * sizeof(Line));
+    if(lines == ARENA_FAILED) {
+        // The lines are still valid unspliced; the .if just runs as is.
+        free(splices);
+        return block;
+    }
+    Line* out = arena_at(&o->ast->arena, lines);
+    int next = 0;
+    for(int i = 0, s = 0; i < block.len; i++) {
+        if(s < spliced && splices[s].at == i) {
+            Block b = splices[s++].block;
+            memcpy(&out[next], line_at(o, b, 0), b.len * sizeof(Line));
+            next += b.len;
+        } else {
+            out[next++] = *line_at(o, block, i);
+        }
+    }
+    free(splices);
+    return (Block){.lines = lines, .len = len};
+}
+
+Block optimize(Ast* ast, Block block, int slots, bool propagate) {
+    Optimizer o = {
+        .ast = ast, .keep_blocks = false, .propagate = false,
+        .sets = NULL, .known = NULL, .values = NULL,
+    };
+    block = fold_block(&o, block, true);
+    if(!propagate) return block;
+
+    // Dead branches are gone now, so the writes that are left are the
+    // ones that can actually run.
+    o.propagate = true;
+    o.sets = mem_alloc(slots * sizeof(int));
+    o.known = mem_alloc(slots * sizeof(bool));
+    o.values = mem_alloc(slots * sizeof(long));
+    for(int i = 0; i < slots; i++) {
+        o.sets[i] = 0;
+        o.known[i] = false;
+    }
+    count_sets(&o, block);
+    block = fold_block(&o, block, true);
+    free(o.sets);
+    free(o.known);
+    free(o.values);
+    return block;
+}
+
+static void dump_str(FILE* out, const char* str) {
+    fputc('"', out);
+    for(; *str != '\0'; str++) {
+        switch(*str) {
+            case '\n': fputs("\\n", out); break;
+            case '\t': fputs("\\t", out); break;
+            case '\r': fputs("\\r", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '"':  fputs("\\\"", out); break;
+            default:
+                if((unsigned char)*str < 0x20) fprintf(out, "\\x%02x", (unsigned char)*str);
+                else fputc(*str, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void dump_block(FILE* out, const Ast* ast, Block block, const Symbols* syms, int depth) {
+    for(int i = 0; i < block.len; i++) {
+        Line* line = ast_lines(ast, block) + i;
+        Argument* args = ast_args(ast, line);
+        fprintf(out, "%*s", 4 * depth, "");
+        if(line->id == C_VALUE) {
+            fprintf(out, "%ld\n", args[0].as.num);
+            continue;
+        }
+        const char* name = name_of(line->id);
+        fprintf(out, "%s", name ? name : "?");
+        for(int j = 0; j < line->len; j++) {
+            fputc(' ', out);
+            switch(args[j].type) {
+                case ARG_NUM: fprintf(out, "%ld", args[j].as.num); break;
+                case ARG_STR: dump_str(out, ast_str(ast, &args[j])); break;
+                case ARG_VAR: fprintf(out, "$%s", syms->names[args[j].as.slot]); break;
+                case ARG_CMD: fprintf(out, "<cmd>"); break;
+                case ARG_BLOCK:
+                    if(args[j].as.block.len == 0) {
+                        fprintf(out, "{}");
+                        break;
+                    }
+                    fprintf(out, "{\n");
+                    dump_block(out, ast, args[j].as.block, syms, depth + 1);
+                    fprintf(out, "%*s}", 4 * depth, "");
+                    break;
+            }
+        }
+        fputc('\n', out);
+    }
+}
+
+void ast_dump(FILE* out, const Ast* ast, Block block, const Symbols* syms) {
+    dump_block(out, ast, block, syms, 0);
+}
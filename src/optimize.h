@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "parser.h"
+
+// Rewrites a freshly parsed block before it is sealed: arithmetic on
+// literals is folded, .if and .while with literal conditions lose their
+// dead branches, and braced blocks that fold to a constant become that
+// constant. With propagate set, variables that are set exactly once, at
+// top level, to a number are replaced by that number wherever they are
+// read afterwards. That is only sound when block is the whole script.
+// Returns the block to run in place of the one passed in.
+Block optimize(Ast* ast, Block block, int slots, bool propagate);
+
+// Prints the tree in sysh syntax, with folded lines shown as their value.
+void ast_dump(FILE* out, const Ast* ast, Block block, const Symbols* syms);
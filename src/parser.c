@@ -2,159 +2,268 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "arena.h"
+#include "mem.h"
+#include "names.h"
 #include "parser.h"
 #include "scanner.h"
 #include "trie.h"
 
-void block_init(Block* b) {
-    b->len = 0;
-    b->capacity = 0;
-    b->lines = NULL;
+// Lines and arguments are collected on scratch stacks while their parent
+// is still open, then copied into the arena in one piece so every
+// block's lines and every line's arguments end up contiguous.
+typedef struct {
+    Scanner* sc;
+    Symbols* syms;
+    Ast* ast;
+    // The scanner's file name, copied into the arena once per parse.
+    uint32_t file;
+    int lines_len;
+    int lines_capacity;
+    Line* lines;
+    int args_len;
+    int args_capacity;
+    Argument* args;
+} Parser;
+
+void ast_init(Ast* ast) {
+    arena_init(&ast->arena);
+}
+
+void ast_reset(Ast* ast) {
+    arena_reset(&ast->arena);
+}
+
+void ast_free(Ast* ast) {
+    arena_free(&ast->arena);
+}
+
+void ast_seal(Ast* ast) {
+    arena_seal(&ast->arena);
+}
+
+void symbols_init(Symbols* s) {
+    hashmap_init(&s->index);
+    s->len = 0;
+    s->capacity = 0;
+    s->names = NULL;
+    symbols_intern(s, "LAST", 4);
+    symbols_intern(s, "ERRNO", 5);
 }
 
-void block_add(Block* b, Line l) {
-    if(b->capacity <= b->len) {
-        int new_capacity = (b->capacity == 0 ? 8 : 2*(b->capacity));
-        b->lines = realloc(b->lines, new_capacity * sizeof(Line));
-        b->capacity = new_capacity;
+void symbols_free(Symbols* s) {
+    for(int i = 0; i < s->len; i++) {
+        free(s->names[i]);
     }
-    b->lines[b->len] = l;
-    b->len++;
+    free(s->names);
+    hashmap_free(&s->index);
 }
 
-void block_free(Block* b) {
-    for(int i = 0; i < b->len; i++) {
-        line_free(&b->lines[i]);
+int symbols_intern(Symbols* s, const char* str, int len) {
+    char name[len + 1];
+    memcpy(name, str, len);
+    name[len] = '\0';
+    long slot;
+    if(hashmap_get(&s->index, name, &slot)) return slot;
+    if(s->capacity <= s->len) {
+        int new_capacity = (s->capacity == 0 ? 8 : 2*(s->capacity));
+        s->names = mem_realloc(s->names, new_capacity * sizeof(char*));
+        s->capacity = new_capacity;
     }
-    free(b->lines);
-    block_init(b);
+    s->names[s->len] = mem_strdup(name);
+    hashmap_add(&s->index, name, s->len);
+    return s->len++;
 }
 
-void line_init(Line* l, long id) {
-    l->id = id;
-    l->len = 0;
-    l->capacity = 0;
-    l->args = NULL;
+static void push_line(Parser* p, Line line) {
+    if(p->lines_capacity <= p->lines_len) {
+        int new_capacity = (p->lines_capacity == 0 ? 8 : 2*(p->lines_capacity));
+        p->lines = mem_realloc(p->lines, new_capacity * sizeof(Line));
+        p->lines_capacity = new_capacity;
+    }
+    p->lines[p->lines_len++] = line;
 }
 
-void line_add(Line* l, Argument arg) {
-    if(l->capacity <= l->len) {
-        int new_capacity = (l->capacity == 0 ? 8 : 2*(l->capacity));
-        l->args = realloc(l->args, new_capacity * sizeof(Argument));
-        l->capacity = new_capacity;
+static void push_arg(Parser* p, Argument arg) {
+    if(p->args_capacity <= p->args_len) {
+        int new_capacity = (p->args_capacity == 0 ? 8 : 2*(p->args_capacity));
+        p->args = mem_realloc(p->args, new_capacity * sizeof(Argument));
+        p->args_capacity = new_capacity;
     }
-    l->args[l->len] = arg;
-    l->len++;
+    p->args[p->args_len++] = arg;
 }
 
-void line_free(Line* line) {
-    for(int i = 0; i < line->len; i++) {
-        switch(line->args[i].type) {
-            case ARG_BLOCK:
-                block_free(&line->args[i].as.block);
-                break;
-            case ARG_STR:
-            case ARG_CMD:
-            case ARG_VAR:
-                free((char*)line->args[i].as.str);
-                break;
-            case ARG_NUM:
-                break;
-        }
+// Moves everything pushed since base into the arena.
+static uint32_t flush(Parser* p, void* items, int base, int len, size_t size) {
+    uint32_t offset = arena_alloc(&p->ast->arena, (len - base) * size);
+    if(offset != ARENA_FAILED) {
+        memcpy(arena_at(&p->ast->arena, offset), (char*)items + base * size, (len - base) * size);
     }
-    free(line->args);
+    return offset;
 }
 
-static BlockResult parse_block(Scanner* sc, bool braced);
+static uint32_t add_string(Parser* p, Token* tok) {
+    Arena* arena = &p->ast->arena;
+    uint32_t offset = arena_alloc(arena, tok->as.str.len + 1);
+    if(offset == ARENA_FAILED) return offset;
+    char* buf = arena_at(arena, offset);
+    int len = tok->as.str.len;
+    if(tok->escaped) {
+        len = scanner_unescape(buf, tok->as.str);
+    } else {
+        memcpy(buf, tok->as.str.start, len);
+    }
+    buf[len] = '\0';
+    return offset;
+}
+
+static BlockResult parse_block(Parser* p, bool braced);
+
+typedef RESULT(Line, const char*) LineResult;
 
-static LineResult parse_line(Scanner* sc, int id, bool* brace_end) {
-    Line line;
-    line_init(&line, id);
+static LineResult parse_line(Parser* p, int id, bool* brace_end) {
+    int base = p->args_len;
+    Line line = {
+        .id = id, .len = 0, .args = 0,
+        .file = p->file, .row = p->sc->row, .col = scanner_col(p->sc),
+    };
     while(true) {
-        Token tok = scanner_next(sc);
+        Token tok = scanner_next(p->sc);
         switch(tok.type) {
             case TOK_EOF:
             case TOK_EOL:
-                *brace_end = false;
-                return OK(line, LineResult);
             case TOK_RBRACE:
-                *brace_end = true;
+                *brace_end = (tok.type == TOK_RBRACE);
+                line.len = p->args_len - base;
+                line.args = flush(p, p->args, base, p->args_len, sizeof(Argument));
+                p->args_len = base;
+                if(line.args == ARENA_FAILED) {
+                    return ERR("out of memory", LineResult);
+                }
                 return OK(line, LineResult);
             case TOK_ERR: 
-                line_free(&line);
-                return ERR(tok.as.str, LineResult);
+                p->args_len = base;
+                return ERR(tok.as.msg, LineResult);
             case TOK_INT:
-                line_add(&line, (Argument){.type = ARG_NUM, .as.num = tok.as.num});
-                break;
-            case TOK_VAR:
-                line_add(&line, (Argument){.type = ARG_VAR, .as.str = tok.as.str});
-                break;
-            case TOK_STR: 
-                line_add(&line, (Argument){.type = ARG_STR, .as.str = tok.as.str});
+                push_arg(p, (Argument){.type = ARG_NUM, .as.num = tok.as.num});
                 break;
+            case TOK_VAR: {
+                int slot = symbols_intern(p->syms, tok.as.str.start, tok.as.str.len);
+                push_arg(p, (Argument){.type = ARG_VAR, .as.slot = slot});
+            } break;
+            case TOK_STR: {
+                uint32_t str = add_string(p, &tok);
+                if(str == ARENA_FAILED) {
+                    p->args_len = base;
+                    return ERR("out of memory", LineResult);
+                }
+                push_arg(p, (Argument){.type = ARG_STR, .as.str = str});
+            } break;
             case TOK_CMD:
-                line_add(&line, (Argument){.type = ARG_CMD, .as.str = tok.as.str});
+                push_arg(p, (Argument){.type = ARG_CMD});
                 break;
             case TOK_LBRACE: {
-                BlockResult br = parse_block(sc, true);
+                BlockResult br = parse_block(p, true);
                 if(!br.is_ok) {
-                    line_free(&line);
+                    p->args_len = base;
                     return ERR(br.as.err, LineResult);
                 }
-                line_add(&line, (Argument){.type = ARG_BLOCK, .as.block = br.as.ok});
+                push_arg(p, (Argument){.type = ARG_BLOCK, .as.block = br.as.ok});
             } break;
             default:
-                line_free(&line);
+                p->args_len = base;
                 return ERR("unexpected token in line: %d", LineResult);
         }
     }
 }
 
-static BlockResult parse_block(Scanner* sc, bool braced)  {
-    Block block;
-    block_init(&block);
+// Parse errors are usually literals; the few that name a count are
+// formatted here and stay valid until the next one.
+static _Thread_local char error[96];
+
+// Syscalls must get the arguments they take, so the evaluator never
+// passes a missing one as zero by accident.
+static const char* check_arity(Line line) {
+    if(line.id < 0 || line.id >= SYSCALL_COUNT) return NULL;
+    int min = syscall_min_args[line.id];
+    int max = syscall_args[line.id];
+    if(line.len >= min && line.len <= max) return NULL;
+    if(min == max) {
+        snprintf(error, sizeof(error), "%s takes %d args, got %d", syscall_names[line.id], max, line.len);
+    } else {
+        snprintf(error, sizeof(error), "%s takes %d to %d args, got %d", syscall_names[line.id], min, max, line.len);
+    }
+    return error;
+}
+
+static BlockResult end_block(Parser* p, int base) {
+    Block block = {.lines = 0, .len = p->lines_len - base};
+    block.lines = flush(p, p->lines, base, p->lines_len, sizeof(Line));
+    p->lines_len = base;
+    if(block.lines == ARENA_FAILED) {
+        return ERR("out of memory", BlockResult);
+    }
+    return OK(block, BlockResult);
+}
+
+static BlockResult parse_block(Parser* p, bool braced)  {
+    int base = p->lines_len;
     while(true) {
-        Token tok = scanner_next(sc);
+        Token tok = scanner_next(p->sc);
         if((!braced && tok.type == TOK_EOF) || (braced && tok.type == TOK_RBRACE)) {
-            return OK(block, BlockResult);
+            return end_block(p, base);
         }
         switch(tok.type) {
             case TOK_ERR: 
-                block_free(&block);
-                return ERR(tok.as.str, BlockResult);
+                p->lines_len = base;
+                return ERR(tok.as.msg, BlockResult);
             case TOK_EOL: 
                 continue;
             case TOK_CMD: {
-                long id = trie_get(tok.as.str);
-                token_free(&tok);
+                long id = trie_get(tok.as.str.start, tok.as.str.len);
                 if(id == -1) {
-                    block_free(&block);
+                    p->lines_len = base;
                     return ERR("invalid syscall or command name", BlockResult);
                 }
                 bool brace_end;
-                LineResult sr = parse_line(sc, id, &brace_end);
+                LineResult sr = parse_line(p, id, &brace_end);
                 if(!sr.is_ok) {
-                    block_free(&block);
+                    p->lines_len = base;
                     return ERR(sr.as.err, BlockResult);
                 }
                 if(brace_end && !braced) {
-                    line_free(&sr.as.ok);
-                    block_free(&block);
+                    p->lines_len = base;
                     return ERR("unexpected token in block", BlockResult);
                 }
-                block_add(&block, sr.as.ok);
+                const char* err = check_arity(sr.as.ok);
+                if(err != NULL) {
+                    p->lines_len = base;
+                    return ERR(err, BlockResult);
+                }
+                push_line(p, sr.as.ok);
                 if(brace_end) {
-                    return OK(block, BlockResult);
+                    return end_block(p, base);
                 }
             } break;
             default: 
-                block_free(&block);
+                p->lines_len = base;
                 return ERR("unexpected token in block", BlockResult);
         }
     }
-    return OK(block, BlockResult);
 }
 
-BlockResult parse(Scanner* sc) {
-    return parse_block(sc, false);
+BlockResult parse(Scanner* sc, Symbols* syms, Ast* ast) {
+    Parser p = {
+        .sc = sc, .syms = syms, .ast = ast, .file = 0,
+        .lines_len = 0, .lines_capacity = 0, .lines = NULL,
+        .args_len = 0, .args_capacity = 0, .args = NULL,
+    };
+    size_t name_len = strlen(sc->name) + 1;
+    p.file = arena_alloc(&ast->arena, name_len);
+    if(p.file == ARENA_FAILED) return ERR("out of memory", BlockResult);
+    memcpy(arena_at(&ast->arena, p.file), sc->name, name_len);
+    BlockResult br = parse_block(&p, false);
+    free(p.lines);
+    free(p.args);
+    return br;
 }
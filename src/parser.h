@@ -1,26 +1,34 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
+#include "hashmap.h"
 #include "scanner.h"
 
 #define RESULT(T, E) struct { bool is_ok; union { T ok; E err; } as; }
 #define OK(val, R) (R){.is_ok = 1, .as.ok = (val) }
 #define ERR(val, R) (R){.is_ok = 0, .as.err = (val) }
 
-typedef struct Argument_s Argument;
-
+// The tree is stored flat in an Ast's arena. Children are referenced by
+// arena offset: a Block names a contiguous run of Lines, and a Line a
+// contiguous run of Arguments. Use ast_lines/ast_args/ast_str to reach
+// them.
 typedef struct {
-    long id;
+    uint32_t lines;
     int len;
-    int capacity;
-    Argument* args;
-} Line;
+} Block;
 
+// A line records where its command starts in the source: file is the
+// arena offset of the file's name, and row and col count from 1.
 typedef struct {
+    int id;
     int len;
-    int capacity;
-    Line* lines;
-} Block;
+    uint32_t args;
+    uint32_t file;
+    int row;
+    int col;
+} Line;
 
 typedef enum {
     ARG_BLOCK,
@@ -30,24 +38,60 @@ typedef enum {
     ARG_CMD,
 } ArgType;
 
-struct Argument_s {
+typedef struct {
     ArgType type;
     union {
         Block block;
-        const char* str;
+        uint32_t str;
         long num;
+        int slot;
     } as;
-};
+} Argument;
+
+typedef struct {
+    Arena arena;
+} Ast;
 
 typedef RESULT(Block, const char*) BlockResult;
-typedef RESULT(Line, const char*) LineResult;
 
-void block_init(Block* b);
-void block_add(Block* b, Line l);
-void block_free(Block* b);
+void ast_init(Ast* ast);
+void ast_reset(Ast* ast);
+void ast_free(Ast* ast);
+// Makes the tree and its literals read-only; call before evaluating.
+void ast_seal(Ast* ast);
+
+static inline Line* ast_lines(const Ast* ast, Block block) {
+    return arena_at(&ast->arena, block.lines);
+}
+
+static inline Argument* ast_args(const Ast* ast, const Line* line) {
+    return arena_at(&ast->arena, line->args);
+}
+
+static inline const char* ast_str(const Ast* ast, const Argument* arg) {
+    return arena_at(&ast->arena, arg->as.str);
+}
+
+static inline const char* ast_file(const Ast* ast, const Line* line) {
+    return arena_at(&ast->arena, line->file);
+}
+
+// Variables are resolved to slot indices while parsing. $LAST and $ERRNO
+// always occupy the first two slots so the evaluator can update them
+// without a lookup.
+#define SLOT_LAST   0
+#define SLOT_ERRNO  1
+
+typedef struct {
+    Hashmap index;
+    int len;
+    int capacity;
+    char** names;
+} Symbols;
 
-void line_init(Line* l, long id);
-void line_add(Line* l, Argument a);
-void line_free(Line* l);
+void symbols_init(Symbols* s);
+void symbols_free(Symbols* s);
+int symbols_intern(Symbols* s, const char* name, int len);
 
-BlockResult parse(Scanner* sc);
+// Parses into ast. Several parses may share one ast before it is sealed.
+BlockResult parse(Scanner* sc, Symbols* syms, Ast* ast);
@@ -0,0 +1,215 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "hashmap.h"
+#include "mem.h"
+#include "names.h"
+#include "profile.h"
+#include "trie.h"
+
+// One sample per millisecond of CPU time used by the process.
+#define PROFILE_INTERVAL_US 1000
+// Samples wait in a fixed ring, as the signal handler cannot allocate,
+// until a thread of the profiler's own merges them. The ring holds well
+// over a merge interval's worth of samples for every core.
+#define PROFILE_SAMPLES 4096
+#define PROFILE_MERGE_MS 10
+
+enum { SAMPLE_FREE, SAMPLE_WRITING, SAMPLE_READY };
+
+typedef struct {
+    int state;
+    Shadow stack;
+} Sample;
+
+bool profile_enabled = false;
+
+_Thread_local Shadow shadow;
+
+// lock guards merging and everything below it. Stacks are interned
+// like symbols: index maps a folded stack to its place in stacks and
+// counts.
+static struct {
+    FILE* out;
+    Sample* samples;
+    unsigned long next;
+    long dropped;
+    pthread_t merger;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+    Hashmap index;
+    int len;
+    int capacity;
+    char** stacks;
+    long* counts;
+    size_t key_len;
+    size_t key_capacity;
+    char* key;
+} prof = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+};
+
+// Runs on the thread the timer interrupted, which may be anywhere, so
+// it only copies the thread's stack into a free slot. If the merger has
+// fallen a whole ring behind, the sample is dropped.
+static void sample(int sig) {
+    (void)sig;
+    long depth = shadow.depth;
+    if(depth == 0) return;
+    if(depth > PROFILE_DEPTH) depth = PROFILE_DEPTH;
+    unsigned long i = __atomic_fetch_add(&prof.next, 1, __ATOMIC_RELAXED) % PROFILE_SAMPLES;
+    Sample* s = &prof.samples[i];
+    int expected = SAMPLE_FREE;
+    if(!__atomic_compare_exchange_n(&s->state, &expected, SAMPLE_WRITING, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&prof.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    s->stack.ast = shadow.ast;
+    s->stack.depth = depth;
+    memcpy(s->stack.lines, shadow.lines, depth * sizeof(Line*));
+    __atomic_store_n(&s->state, SAMPLE_READY, __ATOMIC_RELEASE);
+}
+
+static void key_add(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+static void key_add(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if(prof.key_capacity <= prof.key_len + len) {
+        size_t new_capacity = (prof.key_capacity == 0 ? 256 : 2*prof.key_capacity);
+        while(new_capacity <= prof.key_len + len) new_capacity *= 2;
+        prof.key = mem_realloc(prof.key, new_capacity);
+        prof.key_capacity = new_capacity;
+    }
+    va_start(args, format);
+    vsnprintf(prof.key + prof.key_len, len + 1, format, args);
+    va_end(args);
+    prof.key_len += len;
+}
+
+// Folds a stack into "name file:row:col" frames, outermost first.
+static void fold(const Shadow* stack) {
+    prof.key_len = 0;
+    for(long i = 0; i < stack->depth; i++) {
+        const Line* line = stack->lines[i];
+        // Lines the optimizer folded to a constant have no name.
+        const char* name = (line->id == C_VALUE) ? "(constant)" : name_of(line->id);
+        key_add("%s%s %s:%d:%d", i == 0 ? "" : ";", name != NULL ? name : "?",
+                ast_file(stack->ast, line), line->row, line->col);
+    }
+}
+
+static void count(const char* key) {
+    long i;
+    if(hashmap_get(&prof.index, key, &i)) {
+        prof.counts[i]++;
+        return;
+    }
+    if(prof.capacity <= prof.len) {
+        int new_capacity = (prof.capacity == 0 ? 64 : 2*prof.capacity);
+        prof.stacks = mem_realloc(prof.stacks, new_capacity * sizeof(char*));
+        prof.counts = mem_realloc(prof.counts, new_capacity * sizeof(long));
+        prof.capacity = new_capacity;
+    }
+    prof.stacks[prof.len] = mem_strdup(key);
+    prof.counts[prof.len] = 1;
+    hashmap_add(&prof.index, key, prof.len++);
+}
+
+// Call with lock held.
+static void merge(void) {
+    for(int i = 0; i < PROFILE_SAMPLES; i++) {
+        Sample* s = &prof.samples[i];
+        if(__atomic_load_n(&s->state, __ATOMIC_ACQUIRE) != SAMPLE_READY) continue;
+        fold(&s->stack);
+        count(prof.key);
+        __atomic_store_n(&s->state, SAMPLE_FREE, __ATOMIC_RELEASE);
+    }
+}
+
+static void* merger(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&prof.lock);
+    while(!prof.stopping) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += PROFILE_MERGE_MS * 1000000L;
+        if(until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&prof.wake, &prof.lock, &until);
+        merge();
+    }
+    pthread_mutex_unlock(&prof.lock);
+    return NULL;
+}
+
+bool profile_start(const char* path) {
+    prof.out = fopen(path, "we");
+    if(prof.out == NULL) return false;
+    prof.samples = mem_alloc(PROFILE_SAMPLES * sizeof(Sample));
+    for(int i = 0; i < PROFILE_SAMPLES; i++) prof.samples[i].state = SAMPLE_FREE;
+    hashmap_init(&prof.index);
+    profile_enabled = true;
+    pthread_create(&prof.merger, NULL, merger, NULL);
+
+    // Restarting keeps the timer from failing the script's own syscalls
+    // with EINTR.
+    struct sigaction sa = {.sa_handler = sample, .sa_flags = SA_RESTART};
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+    struct itimerval timer = {
+        .it_interval = {.tv_sec = 0, .tv_usec = PROFILE_INTERVAL_US},
+        .it_value = {.tv_sec = 0, .tv_usec = PROFILE_INTERVAL_US},
+    };
+    setitimer(ITIMER_PROF, &timer, NULL);
+    return true;
+}
+
+void profile_flush(void) {
+    if(!profile_enabled) return;
+    pthread_mutex_lock(&prof.lock);
+    merge();
+    pthread_mutex_unlock(&prof.lock);
+}
+
+void profile_stop(void) {
+    if(!profile_enabled) return;
+    setitimer(ITIMER_PROF, &(struct itimerval){0}, NULL);
+    // A signal may still be pending; it must not find the ring freed.
+    struct sigaction sa = {.sa_handler = SIG_IGN};
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+
+    pthread_mutex_lock(&prof.lock);
+    prof.stopping = true;
+    pthread_cond_signal(&prof.wake);
+    pthread_mutex_unlock(&prof.lock);
+    pthread_join(prof.merger, NULL);
+    merge();
+    profile_enabled = false;
+
+    for(int i = 0; i < prof.len; i++) {
+        fprintf(prof.out, "%s %ld\n", prof.stacks[i], prof.counts[i]);
+        free(prof.stacks[i]);
+    }
+    fclose(prof.out);
+    if(prof.dropped > 0) fprintf(stderr, "sysh: profiler dropped %ld samples\n", prof.dropped);
+    free(prof.stacks);
+    free(prof.counts);
+    free(prof.key);
+    free(prof.samples);
+    hashmap_free(&prof.index);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "parser.h"
+
+// Sampling profiler for scripts. While it runs, every engine keeps a
+// shadow stack per thread of the lines it is inside, one per level of
+// block nesting, and a SIGPROF timer copies the stack of whichever
+// thread is using the CPU. Samples are merged into counts per distinct
+// stack and written as folded stacks, one "frame;frame;... count" line
+// each, for flamegraph.pl and similar tools.
+#define PROFILE_DEPTH 64
+
+typedef struct {
+    const Ast* ast;
+    long depth;
+    const Line* lines[PROFILE_DEPTH];
+} Shadow;
+
+// Set by profile_start. Engines only keep their shadow stacks while it
+// is set, so the profiler costs nothing otherwise.
+extern bool profile_enabled;
+
+extern _Thread_local Shadow shadow;
+
+// Marks line as the one running at level, counting from 0 for the lines
+// of the outermost block. Levels beyond PROFILE_DEPTH are counted but
+// not recorded.
+static inline void shadow_enter(long level, const Line* line) {
+    if(level < PROFILE_DEPTH) shadow.lines[level] = line;
+    // The timer interrupts this thread, so ordering the stores for a
+    // signal handler on it is enough.
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    shadow.depth = level + 1;
+}
+
+// Leaves the block at level, returning to the line that contains it.
+static inline void shadow_leave(long level) {
+    shadow.depth = level;
+}
+
+// Starts sampling, to be written to path by profile_stop. Returns false
+// and leaves errno set if path cannot be created.
+bool profile_start(const char* path);
+
+// Merges the samples taken so far. Must be called before the lines they
+// refer to are reset or freed, once no thread runs them any more.
+void profile_flush(void);
+
+// Stops sampling and writes the folded stacks.
+void profile_stop(void);
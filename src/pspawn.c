@@ -0,0 +1,96 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "coalesce.h"
+#include "mem.h"
+#include "pspawn.h"
+
+extern char** environ;
+
+// Splits words into a NULL-terminated vector, or returns NULL if a quote
+// is not closed. The vector and the words share one allocation, so
+// freeing the vector frees both.
+static char** split(const char* words) {
+    size_t len = strlen(words);
+    // At most one word for every two characters, and the terminator.
+    // Unquoting only shortens words, so they fit in a copy of the input.
+    size_t slots = len / 2 + 2;
+    char** vec = mem_alloc(slots * sizeof(char*) + len + 1);
+    char* out = (char*)(vec + slots);
+    const char* p = words;
+    int n = 0;
+    while(true) {
+        while(*p == ' ' || *p == '\t') p++;
+        if(*p == '\0') break;
+        vec[n++] = out;
+        char quote = 0;
+        while(*p != '\0' && (quote != 0 || (*p != ' ' && *p != '\t'))) {
+            char c = *p++;
+            if(c == quote) quote = 0;
+            else if(quote == 0 && (c == '\'' || c == '"')) quote = c;
+            else if(c == '\\' && quote != '\'' && *p != '\0') *out++ = *p++;
+            else *out++ = c;
+        }
+        if(quote != 0) {
+            free(vec);
+            return NULL;
+        }
+        *out++ = '\0';
+    }
+    vec[n] = NULL;
+    return vec;
+}
+
+long pspawn(const char* path, const char* argv, const char* envp, int in, int out, int err) {
+    // Each redirection is made from a copy of its fd, so one that lands
+    // on 0, 1 or 2 cannot replace an fd another still reads from, as when
+    // out and err are swapped. The copies are closed on exec.
+    int fds[3] = {in, out, err};
+    int copies[3] = {-1, -1, -1};
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_t* use = NULL;
+    char* path_only[2] = {(char*)path, NULL};
+    char** args = path_only;
+    char** env = environ;
+    pid_t pid;
+    int result = 0;
+    for(int i = 0; i < 3; i++) {
+        if(fds[i] < 0 || fds[i] == i) continue;
+        copies[i] = fcntl(fds[i], F_DUPFD_CLOEXEC, 3);
+        if(copies[i] < 0) {
+            result = errno;
+            break;
+        }
+        if(use == NULL) {
+            posix_spawn_file_actions_init(&actions);
+            use = &actions;
+        }
+        posix_spawn_file_actions_adddup2(use, copies[i], i);
+    }
+    if(result == 0 && argv != NULL && (args = split(argv)) == NULL) result = EINVAL;
+    if(result == 0 && envp != NULL && (env = split(envp)) == NULL) result = EINVAL;
+
+    if(result == 0) {
+        // The child must not write before output the script already wrote.
+        coalesce_flush();
+        result = posix_spawn(&pid, path, use, NULL, args, env);
+    }
+
+    if(args != path_only) free(args);
+    if(env != environ) free(env);
+    if(use != NULL) posix_spawn_file_actions_destroy(use);
+    for(int i = 0; i < 3; i++) {
+        if(copies[i] >= 0) close(copies[i]);
+    }
+    if(result != 0) {
+        errno = result;
+        return -1;
+    }
+    return pid;
+}
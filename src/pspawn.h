@@ -0,0 +1,19 @@
+#pragma once
+
+// Starts the program at path as a new process and returns its pid. The
+// child is created with posix_spawn, which shares the parent's memory
+// until it execs instead of copying its page tables, so no interpreter
+// code runs in it.
+//
+// argv and envp are strings of words separated by spaces or tabs. As in
+// a shell, quotes keep a word together: within single quotes every
+// character stands for itself, and elsewhere a backslash does the same
+// for the character after it. argv starts with the program's name, and
+// if it is NULL the program gets just path. If envp is NULL the
+// environment of sysh is passed on. in, out and err become the child's
+// stdin, stdout and stderr unless they are negative, in which case
+// sysh's own are kept.
+//
+// Returns -1 with errno set if the process cannot be started, with
+// EINVAL for an unclosed quote.
+long pspawn(const char* path, const char* argv, const char* envp, int in, int out, int err);
@@ -0,0 +1,180 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mem.h"
+#include "pump.h"
+#include "sys.h"
+
+// Largest count passed to one call; the kernel caps most of them lower.
+#define PUMP_CALL (1L << 30)
+#define PUMP_PIPE (1024 * 1024)
+#define PUMP_BUF (1024 * 1024)
+
+typedef struct {
+    int src;
+    int dst;
+    long n;
+    long moved;
+} Pump;
+
+// The data movement goes through sys_call so --trace-summary shows it.
+static long call(long id, long a, long b, long c, long d, long e, long f) {
+    long args[6] = {a, b, c, d, e, f};
+    long result;
+    do {
+        result = sys_call(id, args);
+    } while(result == -EINTR);
+    errno = sys_error(result);
+    return errno != 0 ? -1 : result;
+}
+
+static long remaining(Pump* p) {
+    if(p->n < 0 || p->n - p->moved > PUMP_CALL) return PUMP_CALL;
+    return p->n - p->moved;
+}
+
+static bool more(Pump* p) {
+    return p->n < 0 || p->moved < p->n;
+}
+
+// The errors a kernel copy fails with when it does not support the fds
+// it was given, in which case the next method is tried. EBADF is what
+// copy_file_range returns for a destination opened with O_APPEND.
+static bool unsupported(void) {
+    return errno == EINVAL || errno == ENOSYS || errno == EXDEV
+        || errno == EOPNOTSUPP || errno == EBADF;
+}
+
+// Each method below moves data until it is done or a call fails. It
+// returns false, with errno cleared, if the failure only means it cannot
+// serve these fds; otherwise errno tells whether it stopped on an error.
+static bool fall_through(void) {
+    if(!unsupported()) return true;
+    errno = 0;
+    return false;
+}
+
+static bool by_copy_file_range(Pump* p) {
+    while(more(p)) {
+        long r = call(SYS_copy_file_range, p->src, 0, p->dst, 0, remaining(p), 0);
+        if(r < 0) return fall_through();
+        if(r == 0) break;
+        p->moved += r;
+    }
+    return true;
+}
+
+static bool by_sendfile(Pump* p) {
+    while(more(p)) {
+        long r = call(SYS_sendfile, p->dst, p->src, 0, remaining(p), 0, 0);
+        if(r < 0) return fall_through();
+        if(r == 0) break;
+        p->moved += r;
+    }
+    return true;
+}
+
+static bool by_splice(Pump* p) {
+    while(more(p)) {
+        long r = call(SYS_splice, p->src, 0, p->dst, 0, remaining(p), SPLICE_F_MOVE);
+        if(r < 0) return fall_through();
+        if(r == 0) break;
+        p->moved += r;
+    }
+    return true;
+}
+
+// Writes all of len bytes, returning false on an error.
+static bool write_all(int fd, const char* buf, long len) {
+    while(len > 0) {
+        long w = call(SYS_write, fd, (long)buf, len, 0, 0, 0);
+        if(w < 0) return false;
+        buf += w;
+        len -= w;
+    }
+    return true;
+}
+
+// Moves whatever is left in the pipe to dst the slow way, after dst
+// turned out not to accept splices.
+static bool drain(Pump* p, int pipe_out, long len) {
+    char* buf = mem_alloc(PUMP_BUF);
+    bool ok = true;
+    while(ok && len > 0) {
+        long r = call(SYS_read, pipe_out, (long)buf, len < PUMP_BUF ? len : PUMP_BUF, 0, 0, 0);
+        ok = r > 0 && write_all(p->dst, buf, r);
+        if(ok) {
+            p->moved += r;
+            len -= r;
+        }
+    }
+    free(buf);
+    return ok;
+}
+
+// Splices from src into a private pipe and from there to dst, so the
+// data never leaves the kernel.
+static bool by_pipe(Pump* p) {
+    int fds[2];
+    if(pipe2(fds, O_CLOEXEC) < 0) {
+        errno = 0;
+        return false;
+    }
+    fcntl(fds[1], F_SETPIPE_SZ, PUMP_PIPE);
+    bool served = true;
+    while(more(p)) {
+        long r = call(SYS_splice, p->src, 0, fds[1], 0, remaining(p), SPLICE_F_MOVE);
+        if(r < 0) {
+            served = fall_through();
+            break;
+        }
+        if(r == 0) break;
+        long left = r;
+        while(left > 0) {
+            long w = call(SYS_splice, fds[0], 0, p->dst, 0, left, SPLICE_F_MOVE);
+            if(w < 0) break;
+            p->moved += w;
+            left -= w;
+        }
+        if(left > 0) {
+            if(unsupported() && drain(p, fds[0], left)) served = false;
+            break;
+        }
+    }
+    close(fds[0]);
+    close(fds[1]);
+    if(!served) errno = 0;
+    return served;
+}
+
+static void by_copy(Pump* p) {
+    char* buf = mem_alloc(PUMP_BUF);
+    while(more(p)) {
+        long want = remaining(p) < PUMP_BUF ? remaining(p) : PUMP_BUF;
+        long r = call(SYS_read, p->src, (long)buf, want, 0, 0, 0);
+        if(r <= 0 || !write_all(p->dst, buf, r)) break;
+        p->moved += r;
+    }
+    free(buf);
+}
+
+long pump(int src, int dst, long n) {
+    struct stat in, out;
+    if(fstat(src, &in) < 0 || fstat(dst, &out) < 0) return -1;
+    Pump p = {.src = src, .dst = dst, .n = n, .moved = 0};
+    errno = 0;
+    bool done = false;
+    if(S_ISREG(in.st_mode) && S_ISREG(out.st_mode)) done = by_copy_file_range(&p);
+    if(!done && S_ISREG(in.st_mode)) done = by_sendfile(&p);
+    if(!done && (S_ISFIFO(in.st_mode) || S_ISFIFO(out.st_mode))) done = by_splice(&p);
+    if(!done) done = by_pipe(&p);
+    if(!done) by_copy(&p);
+    if(p.moved == 0 && errno != 0) return -1;
+    return p.moved;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Moves up to n bytes from src to dst, or everything up to end of file
+// if n is negative, without passing them through the interpreter. The
+// kernel copies the data itself where it can: copy_file_range between
+// regular files, sendfile from a regular file, splice when either side
+// is a pipe or through a private pipe otherwise. Anything else is copied
+// through a buffer with read and write.
+//
+// Returns the number of bytes moved. If an error stops the copy, errno
+// is left set, and -1 is returned if nothing was moved.
+long pump(int src, int dst, long n);
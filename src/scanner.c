@@ -6,22 +6,20 @@
 // Based heavily on the scanner implementation 
 // from Crafting Interpreters by Robert Nystrom
 
-Scanner init_scanner(char *src) {
-    return (Scanner){.start=src, .current=src, .eof=(*src == '\0')};
-}
-
-void token_free(Token* tok) {
-    if(tok->type == TOK_STR || tok->type == TOK_CMD || tok->type == TOK_VAR) {
-        free((char*)(tok->as.str));
-    }
+Scanner init_scanner(const char* src, size_t len) {
+    return (Scanner){
+        .start=src, .current=src, .end=src+len, .eof=(len == 0 || *src == '\0'),
+        .name="-", .row=1, .row_start=src,
+    };
 }
 
 static char peek(const Scanner* sc) {
+    if(sc->current == sc->end) return '\0';
     return *sc->current;
 }
 
 static char next(Scanner* sc) {
-    if(*sc->current == '\0') {
+    if(sc->current == sc->end || *sc->current == '\0') {
         sc->eof = true;
         return '\0';
     }
@@ -30,6 +28,13 @@ static char next(Scanner* sc) {
     return c;
 }
 
+// Newlines only appear as line ends and inside strings, so only those
+// places count rows.
+static void newline(Scanner* sc) {
+    sc->row++;
+    sc->row_start = sc->current;
+}
+
 static bool is_alnum(char c) {
     return (c >= 'a' && c <= 'z')
         || (c >= 'A' && c <= 'Z')
@@ -43,11 +48,18 @@ static bool is_digit(char c) {
 static Token err_token(const char* msg) {
     Token token = {
         .type = TOK_ERR, 
-        .as.str = msg,
+        .as.msg = msg,
     };
     return token;
 }
 
+static Token slice_token(TokenType type, const char* start, const char* end) {
+    return (Token){
+        .type = type,
+        .as.str = {.start = start, .len = end - start},
+    };
+}
+
 static void skip_ws(Scanner* sc) {
     while(true) {
         char c = peek(sc);
@@ -68,94 +80,102 @@ static void skip_ws(Scanner* sc) {
 }
 
 static Token scan_string(Scanner* sc) {
-    while(peek(sc) != '\0' && peek(sc) != '\'') next(sc);
+    while(peek(sc) != '\0' && peek(sc) != '\'') {
+        if(next(sc) == '\n') newline(sc);
+    }
     if(peek(sc) == '\0') return err_token("EOF while scanning raw string");
     next(sc);
 
-    int len = sc->current - sc->start - 2;
-    char* buf = malloc((len + 1) * sizeof(char));
-    memcpy(buf, sc->start + 1, len);
-    buf[len] = '\0';
-    return (Token){
-        .type = TOK_STR,
-        .as.str = buf,
-    };
+    return slice_token(TOK_STR, sc->start + 1, sc->current - 1);
 }
 
-static char* add_char(char* buf, int* len, int* capacity, char new) {
-    if(*len == *capacity) {
-        int new_capacity = (*capacity == 0 ? 8 : 2*(*capacity));
-        buf = realloc(buf, new_capacity);
-        *capacity = new_capacity;
+static char escape(char c) {
+    switch(c) {
+        case '\\': return '\\';
+        case '"':  return '"';
+        case 'n':  return '\n';
+        case 'r':  return '\r';
+        case 't':  return '\t';
+        case '0':  return '\0';
+        default:   return -1;
     }
-    buf[*len] = new;
-    (*len)++;
-    return buf;
 }
 
+// Only validates the string; decoding is left to scanner_unescape so that
+// strings without escapes never need a copy.
 static Token scan_escape_string(Scanner* sc) {
-    char* buf = NULL;
-    int len = 0;
-    int capacity = 0;
+    bool escaped = false;
     char c;
     while(true) {
         c = next(sc);
         if(c == '"') break;
+        if(c == '\n') newline(sc);
         if(c == '\0') {
-            free(buf);
             return err_token("EOF while scanning double-quoted string");
         }
         if(c == '\\') {
-            switch(next(sc)) {
-                case '\\': buf = add_char(buf, &len, &capacity, '\\'); break;
-                case '"':  buf = add_char(buf, &len, &capacity, '"'); break;
-                case 'n':  buf = add_char(buf, &len, &capacity, '\n'); break;
-                case 'r':  buf = add_char(buf, &len, &capacity, '\r'); break;
-                case 't':  buf = add_char(buf, &len, &capacity, '\t'); break;
-                case '0':  buf = add_char(buf, &len, &capacity, '\0'); break;
-                default: {
-                    free(buf);
-                    return err_token("unknown escape sequence");
-                }
+            if(escape(next(sc)) == -1) {
+                return err_token("unknown escape sequence");
             }
-        } else {
-            buf = add_char(buf, &len, &capacity, c);
+            escaped = true;
         }
     }
 
-    buf = add_char(buf, &len, &capacity, '\0');
-    buf = realloc(buf, len);
+    Token tok = slice_token(TOK_STR, sc->start + 1, sc->current - 1);
+    tok.escaped = escaped;
+    return tok;
+}
 
-    return (Token){
-        .type = TOK_STR,
-        .as.str = buf,
-    };
+int scanner_unescape(char* dst, Slice str) {
+    int len = 0;
+    for(int i = 0; i < str.len; i++) {
+        char c = str.start[i];
+        if(c == '\\') {
+            i++;
+            c = escape(str.start[i]);
+        }
+        dst[len++] = c;
+    }
+    return len;
+}
+
+long scanner_frame(Frame* f, const char* buf, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        char c = buf[i];
+        if(c == '\n') f->rows++;
+        if(f->comment) {
+            if(c == '\n') f->comment = false;
+            else continue;
+        }
+        if(f->quote) {
+            if(f->escape) f->escape = false;
+            else if(c == '\\' && f->quote == '"') f->escape = true;
+            else if(c == f->quote) f->quote = 0;
+            continue;
+        }
+        switch(c) {
+            case '#':  f->comment = true; break;
+            case '\'':
+            case '"':  f->quote = c; break;
+            case '{':  f->depth++; break;
+            // A stray brace is left for the parser to report.
+            case '}':  if(f->depth > 0) f->depth--; break;
+            case '\n': if(f->depth == 0) return i + 1; break;
+        }
+    }
+    return -1;
 }
 
 static Token scan_var(Scanner* sc) {
     while(is_alnum(peek(sc))) next(sc);
     
-    int len = sc->current - sc->start - 1;
-    char* buf = malloc((len + 1) * sizeof(char));
-    memcpy(buf, sc->start + 1, len);
-    buf[len] = '\0';
-    return (Token){
-        .type = TOK_VAR,
-        .as.str = buf,
-    };
+    return slice_token(TOK_VAR, sc->start + 1, sc->current);
 }
 
 static Token scan_cmd(Scanner* sc) {
     while(is_alnum(peek(sc))) next(sc);
 
-    int len = sc->current - sc->start;
-    char* buf = malloc((len + 1) * sizeof(char));
-    memcpy(buf, sc->start, len);
-    buf[len] = '\0';
-    return (Token){
-        .type = TOK_CMD,
-        .as.str = buf,
-    };
+    return slice_token(TOK_CMD, sc->start, sc->current);
 }
 
 static Token scan_num(Scanner* sc) {
@@ -184,7 +204,9 @@ Token scanner_next(Scanner* sc) {
     }
     switch(c) {
         case '\0': return (Token){.type = TOK_EOF};
-        case '\n': 
+        case '\n':
+            newline(sc);
+            return (Token){.type = TOK_EOL};
         case ';': return (Token){.type = TOK_EOL};
         case '{': return (Token){.type = TOK_LBRACE};
         case '}': return (Token){.type = TOK_RBRACE};
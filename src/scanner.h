@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+
 typedef enum {
     TOK_ERR,
     TOK_EOF,
@@ -12,22 +15,62 @@ typedef enum {
     TOK_RBRACE,
 } TokenType;
 
-// TOK_STR, TOK_CMD, TOK_VAR contain allocated data, the rest do not
+// TOK_STR, TOK_CMD and TOK_VAR are slices into the scanned buffer and own
+// no memory. A TOK_STR with escaped set still contains its backslash
+// sequences and must be decoded with scanner_unescape.
+typedef struct {
+    const char* start;
+    int len;
+} Slice;
+
 typedef struct {
     TokenType type;
+    bool escaped;
     union {
-        const char* str;
+        Slice str;
+        const char* msg;
         long num;
     } as;
 } Token;
 
+// name is the file lines are attributed to, "-" unless set after
+// init_scanner. row counts from 1 and can also be set to continue the
+// numbering of earlier input.
 typedef struct {
-    char* start;
-    char* current;
+    const char* start;
+    const char* current;
+    const char* end;
     bool eof;
+    const char* name;
+    int row;
+    const char* row_start;
 } Scanner;
 
-Scanner init_scanner(char* src);
+// Tracks where top-level lines end in input that arrives in pieces, so a
+// stream can be parsed line by line without rescanning. The state
+// survives chunk boundaries in the middle of strings, comments and
+// braced blocks.
+typedef struct {
+    int depth;
+    char quote;
+    bool escape;
+    bool comment;
+    // Newlines passed so far, for numbering the rows of later lines.
+    long rows;
+} Frame;
+
+Scanner init_scanner(const char* src, size_t len);
 Token scanner_next(Scanner* sc);
 
-void token_free(Token* tok);
+// The column, counting from 1, at which the last token returned starts.
+static inline int scanner_col(const Scanner* sc) {
+    return sc->start - sc->row_start + 1;
+}
+
+// Advances frame over buf and returns the offset just past the first
+// newline that ends a top-level line, or -1 if buf holds no line end.
+long scanner_frame(Frame* frame, const char* buf, size_t len);
+
+// Decodes an escaped string slice into dst, which must have room for
+// str.len bytes. Returns the decoded length.
+int scanner_unescape(char* dst, Slice str);
@@ -0,0 +1,97 @@
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "heap.h"
+#include "mem.h"
+#include "stats.h"
+#include "trie.h"
+
+_Static_assert(C_UNPACK > -STATS_COMMANDS, "STATS_COMMANDS too small");
+
+_Thread_local Stats stats;
+
+// Live threads' counters, and the sum of those that have exited.
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static Stats* registry = NULL;
+static Stats retired;
+
+void stats_thread_start(void) {
+    pthread_mutex_lock(&registry_lock);
+    stats.prev = NULL;
+    stats.next = registry;
+    if(registry != NULL) registry->prev = &stats;
+    registry = &stats;
+    pthread_mutex_unlock(&registry_lock);
+}
+
+static void add(Stats* into, const Stats* from) {
+    for(int i = 0; i < STAT_COUNT; i++) {
+        long n = __atomic_load_n(&from->counts[i], __ATOMIC_RELAXED);
+        if(i == STAT_DEPTH) {
+            if(n > into->counts[i]) into->counts[i] = n;
+        } else {
+            into->counts[i] += n;
+        }
+    }
+    for(int i = 0; i < STATS_IDS; i++) {
+        into->lines[i] += __atomic_load_n(&from->lines[i], __ATOMIC_RELAXED);
+    }
+}
+
+void stats_thread_end(void) {
+    pthread_mutex_lock(&registry_lock);
+    add(&retired, &stats);
+    if(stats.prev != NULL) stats.prev->next = stats.next;
+    else registry = stats.next;
+    if(stats.next != NULL) stats.next->prev = stats.prev;
+    pthread_mutex_unlock(&registry_lock);
+}
+
+static void total(Stats* sum) {
+    *sum = (Stats){0};
+    pthread_mutex_lock(&registry_lock);
+    add(sum, &retired);
+    for(Stats* s = registry; s != NULL; s = s->next) add(sum, s);
+    pthread_mutex_unlock(&registry_lock);
+    for(int i = 0; i < STATS_IDS; i++) sum->counts[STAT_LINES] += sum->lines[i];
+    // Allocations are already counted where they happen.
+    sum->counts[STAT_ALLOCS] = heap_stat(HEAP_ALLOCS);
+    sum->counts[STAT_MEM_ALLOCS] = __atomic_load_n(&mem_allocs, __ATOMIC_RELAXED);
+}
+
+long stats_get(long stat) {
+    if(stat < 0 || stat >= STAT_COUNT) return -1;
+    Stats sum;
+    total(&sum);
+    return sum.counts[stat];
+}
+
+void stats_dump(FILE* out) {
+    static const char* keys[STAT_COUNT] = {
+        [STAT_LINES] = "lines",
+        [STAT_SYSCALLS] = "syscalls",
+        [STAT_PROBES] = "hashmap_probes",
+        [STAT_RESIZES] = "hashmap_resizes",
+        [STAT_CLONES] = "string_clones",
+        [STAT_ALLOCS] = "heap_allocs",
+        [STAT_MEM_ALLOCS] = "interpreter_allocs",
+        [STAT_DEPTH] = "max_depth",
+    };
+    Stats sum;
+    total(&sum);
+    fprintf(out, "{");
+    for(int i = 0; i < STAT_COUNT; i++) {
+        fprintf(out, "\"%s\": %ld, ", keys[i], sum.counts[i]);
+    }
+    fprintf(out, "\"lines_by_name\": {");
+    bool first = true;
+    for(int i = 0; i < STATS_IDS; i++) {
+        if(sum.lines[i] == 0) continue;
+        long id = i - STATS_COMMANDS;
+        // Lines the optimizer folded to a constant have no name.
+        const char* name = (id == C_VALUE) ? "(constant)" : name_of(id);
+        fprintf(out, "%s\"%s\": %ld", first ? "" : ", ", name != NULL ? name : "?", sum.lines[i]);
+        first = false;
+    }
+    fprintf(out, "}}\n");
+}
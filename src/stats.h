@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "names.h"
+
+// Counters for where the interpreter spends its work, always on. Each
+// thread counts into its own copy, so counting is a plain increment;
+// reading sums every thread's counts. .stats returns one of them, and
+// with SYSH_STATS=1 in the environment all of them are printed as JSON
+// at exit.
+typedef enum {
+    STAT_LINES,       // lines run
+    STAT_SYSCALLS,    // syscalls issued, including ops queued by .batch
+    STAT_PROBES,      // hashmap groups probed
+    STAT_RESIZES,     // hashmap rebuilds
+    STAT_CLONES,      // string literals copied onto the heap by .set
+    STAT_ALLOCS,      // allocations from the script heap
+    STAT_MEM_ALLOCS,  // allocations for the interpreter's own use
+    STAT_DEPTH,       // deepest nesting of blocks run within a line or task
+    STAT_COUNT,
+} Stat;
+
+// Lines are also counted per syscall or command id. Command ids are
+// negative, so they are stored below the syscalls.
+#define STATS_COMMANDS 48
+#define STATS_IDS (STATS_COMMANDS + SYSCALL_COUNT)
+
+typedef struct Stats {
+    long counts[STAT_COUNT];
+    long lines[STATS_IDS];
+    struct Stats* next;
+    struct Stats* prev;
+} Stats;
+
+extern _Thread_local Stats stats;
+
+// Only the owning thread writes its counts. The atomic stores compile to
+// plain moves, but let other threads read the counts while they change.
+static inline void stats_bump(Stat stat) {
+    __atomic_store_n(&stats.counts[stat], stats.counts[stat] + 1, __ATOMIC_RELAXED);
+}
+
+static inline void stats_line(long id) {
+    __atomic_store_n(&stats.lines[id + STATS_COMMANDS], stats.lines[id + STATS_COMMANDS] + 1, __ATOMIC_RELAXED);
+}
+
+static inline void stats_depth(long depth) {
+    if(depth > stats.counts[STAT_DEPTH]) __atomic_store_n(&stats.counts[STAT_DEPTH], depth, __ATOMIC_RELAXED);
+}
+
+// Threads that run script code call these when they start and before
+// they exit. The counts of threads that have exited are kept.
+void stats_thread_start(void);
+void stats_thread_end(void);
+
+// Returns a statistic summed over all threads, or -1 for an unknown one.
+long stats_get(long stat);
+
+// Prints every counter as one JSON object.
+void stats_dump(FILE* out);
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdbool.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "coalesce.h"
+#include "names.h"
+#include "stats.h"
+#include "trace.h"
+#include "vdso.h"
+
+// The syscall instruction, once per argument count, so each call loads
+// only the registers its syscall reads. Results are the kernel's own:
+// -errno on failure, with errno left alone.
+static inline long sys_raw0(long id) {
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id) : "rcx", "r11", "memory");
+    return result;
+}
+
+static inline long sys_raw1(long id, long a) {
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id), "D"(a) : "rcx", "r11", "memory");
+    return result;
+}
+
+static inline long sys_raw2(long id, long a, long b) {
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id), "D"(a), "S"(b) : "rcx", "r11", "memory");
+    return result;
+}
+
+static inline long sys_raw3(long id, long a, long b, long c) {
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id), "D"(a), "S"(b), "d"(c) : "rcx", "r11", "memory");
+    return result;
+}
+
+static inline long sys_raw4(long id, long a, long b, long c, long d) {
+    long result;
+    register long r10 __asm__("r10") = d;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id), "D"(a), "S"(b), "d"(c), "r"(r10)
+                     : "rcx", "r11", "memory");
+    return result;
+}
+
+static inline long sys_raw5(long id, long a, long b, long c, long d, long e) {
+    long result;
+    register long r10 __asm__("r10") = d;
+    register long r8 __asm__("r8") = e;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8)
+                     : "rcx", "r11", "memory");
+    return result;
+}
+
+static inline long sys_raw6(long id, long a, long b, long c, long d, long e, long f) {
+    long result;
+    register long r10 __asm__("r10") = d;
+    register long r8 __asm__("r8") = e;
+    register long r9 __asm__("r9") = f;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(id), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8), "r"(r9)
+                     : "rcx", "r11", "memory");
+    return result;
+}
+
+// The id a script's syscall is issued as. exit would end only the
+// calling thread, leaving the process running on its task pool and
+// profiler threads, and a task that calls it would never finish; it
+// ends the whole process instead, as exit_group.
+static inline long sys_id(long id) {
+    return (id == SYS_exit) ? SYS_exit_group : id;
+}
+
+// Issues a syscall, through the vDSO where the kernel offers one. args
+// must hold as many values as the syscall takes, with any optional ones
+// left out by the script set to zero.
+static inline long sys_direct(long id, const long* args) {
+    id = sys_id(id);
+    if((unsigned long)id >= SYSCALL_COUNT) return sys_raw6(id, args[0], args[1], args[2], args[3], args[4], args[5]);
+    // The vDSO entries report failure as -errno too.
+    if(vdso_table[id] != NULL) return vdso_call(id, args);
+    switch(syscall_args[id]) {
+        case 0: return sys_raw0(id);
+        case 1: return sys_raw1(id, args[0]);
+        case 2: return sys_raw2(id, args[0], args[1]);
+        case 3: return sys_raw3(id, args[0], args[1], args[2]);
+        case 4: return sys_raw4(id, args[0], args[1], args[2], args[3]);
+        case 5: return sys_raw5(id, args[0], args[1], args[2], args[3], args[4]);
+        default: return sys_raw6(id, args[0], args[1], args[2], args[3], args[4], args[5]);
+    }
+}
+
+// Issues a syscall on a script's behalf, counted and, with tracing on,
+// traced. Returns -errno on failure; see sys_error().
+static inline long sys_issue(long id, const long* args) {
+    stats_bump(STAT_SYSCALLS);
+    if(__builtin_expect(trace_enabled, 0)) return trace_call(id, args);
+    return sys_direct(id, args);
+}
+
+// Single entry point for syscalls issued by scripts. With coalescing and
+// tracing off this is two predictable branches in front of sys_direct().
+// Returns as sys_issue.
+static inline long sys_call(long id, const long* args) {
+    if(__builtin_expect(coalesce_enabled, 0)) return coalesce_call(id, args);
+    return sys_issue(id, args);
+}
+
+// The errno a raw result stands for, or 0 if the call succeeded.
+static inline long sys_error(long result) {
+    return (result < 0 && result > -4096) ? -result : 0;
+}
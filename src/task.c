@@ -0,0 +1,253 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mem.h"
+#include "stats.h"
+#include "task.h"
+
+typedef struct {
+    Ast* ast;
+    Block block;
+    Vars vars;
+    long result;
+    bool done;
+} Task;
+
+// The owner pushes and pops at the bottom, so it runs the task it queued
+// most recently while its caches are warm. Thieves take from the top,
+// where the oldest and usually largest pieces of work are.
+typedef struct {
+    pthread_mutex_t lock;
+    int top;
+    int bottom;
+    int capacity;
+    Task** items;
+} Deque;
+
+long (*task_runner)(Ast* ast, Block block, Vars* vars) = eval_run;
+
+// The pool is started by the first .spawn. lock guards the fields below
+// it and is what idle threads sleep on. Each deque has its own lock, so
+// threads looking for work do not contend on the pool's.
+static struct {
+    bool started;
+    int workers;
+    int threads_len;
+    pthread_t* threads;
+    Deque* deques;
+    long queued;
+    long next;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+    long pending;
+    int handles_len;
+    int handles_capacity;
+    Task** handles;
+    int unused_len;
+    int* unused;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+};
+
+// The deque a thread pushes to, or -1 on threads outside the pool.
+static _Thread_local int self = -1;
+
+static void push(Deque* d, Task* task) {
+    pthread_mutex_lock(&d->lock);
+    if(d->bottom == d->capacity) {
+        if(d->top > 0) {
+            memmove(d->items, d->items + d->top, (d->bottom - d->top) * sizeof(Task*));
+            d->bottom -= d->top;
+            d->top = 0;
+        }
+        if(d->bottom == d->capacity) {
+            d->capacity = (d->capacity == 0 ? 16 : 2*d->capacity);
+            d->items = mem_realloc(d->items, d->capacity * sizeof(Task*));
+        }
+    }
+    d->items[d->bottom++] = task;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static Task* pop(Deque* d, bool steal) {
+    pthread_mutex_lock(&d->lock);
+    Task* task = NULL;
+    if(d->top < d->bottom) {
+        task = steal ? d->items[d->top++] : d->items[--d->bottom];
+        if(d->top == d->bottom) d->top = d->bottom = 0;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return task;
+}
+
+// Finds a queued task: the newest on this thread's own deque, otherwise
+// the oldest on the next deque that has one.
+static Task* take(void) {
+    if(__atomic_load_n(&pool.queued, __ATOMIC_ACQUIRE) == 0) return NULL;
+    Task* task = NULL;
+    if(self >= 0) task = pop(&pool.deques[self], false);
+    int start = (self >= 0) ? self + 1 : 0;
+    for(int i = 0; task == NULL && i < pool.workers; i++) {
+        int victim = (start + i) % pool.workers;
+        if(victim != self) task = pop(&pool.deques[victim], true);
+    }
+    if(task != NULL) __atomic_fetch_sub(&pool.queued, 1, __ATOMIC_RELAXED);
+    return task;
+}
+
+static void run(Task* task) {
+    int saved = errno;
+    errno = 0;
+    task->result = task_runner(task->ast, task->block, &task->vars);
+    errno = saved;
+    vars_free(&task->vars);
+    pthread_mutex_lock(&pool.lock);
+    __atomic_store_n(&task->done, true, __ATOMIC_RELEASE);
+    __atomic_fetch_sub(&pool.pending, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+}
+
+static bool finished(Task* task) {
+    if(task == NULL) return __atomic_load_n(&pool.pending, __ATOMIC_ACQUIRE) == 0;
+    return __atomic_load_n(&task->done, __ATOMIC_ACQUIRE);
+}
+
+// Runs queued tasks until task has finished, or every task if it is
+// NULL, and sleeps only when there is nothing to run.
+static void help(Task* task) {
+    while(!finished(task)) {
+        Task* next = take();
+        if(next != NULL) {
+            run(next);
+            continue;
+        }
+        pthread_mutex_lock(&pool.lock);
+        while(!finished(task) && __atomic_load_n(&pool.queued, __ATOMIC_ACQUIRE) == 0) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+    }
+}
+
+static void* worker(void* arg) {
+    self = (int)(long)arg;
+    stats_thread_start();
+    while(true) {
+        Task* task = take();
+        if(task != NULL) {
+            run(task);
+            continue;
+        }
+        pthread_mutex_lock(&pool.lock);
+        while(!pool.stopping && __atomic_load_n(&pool.queued, __ATOMIC_ACQUIRE) == 0) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        bool stopping = pool.stopping;
+        pthread_mutex_unlock(&pool.lock);
+        if(stopping) {
+            stats_thread_end();
+            return NULL;
+        }
+    }
+}
+
+static void start(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    pool.workers = (cores < 1) ? 1 : cores;
+    pool.deques = mem_alloc(pool.workers * sizeof(Deque));
+    pool.threads = mem_alloc(pool.workers * sizeof(pthread_t));
+    for(int i = 0; i < pool.workers; i++) {
+        pool.deques[i] = (Deque){.top = 0, .bottom = 0, .capacity = 0, .items = NULL};
+        pthread_mutex_init(&pool.deques[i].lock, NULL);
+    }
+    // If no thread can be started, tasks still run inside .join.
+    pool.threads_len = 0;
+    for(int i = 0; i < pool.workers; i++) {
+        if(pthread_create(&pool.threads[pool.threads_len], NULL, worker, (void*)(long)i) != 0) break;
+        pool.threads_len++;
+    }
+    pool.started = true;
+}
+
+long task_spawn(Ast* ast, Block block, Vars* parent) {
+    Task* task = mem_alloc(sizeof(Task));
+    *task = (Task){.ast = ast, .block = block, .result = 0, .done = false};
+    vars_init(&task->vars);
+    vars_resize(&task->vars, parent->len);
+    memcpy(task->vars.values, parent->values, parent->len * sizeof(long));
+    memcpy(task->vars.set, parent->set, parent->len * sizeof(bool));
+
+    // Handles are small integers. As with file descriptors, the handle
+    // of a joined task may be handed out again.
+    pthread_mutex_lock(&pool.lock);
+    if(!pool.started) start();
+    int index;
+    if(pool.unused_len > 0) {
+        index = pool.unused[--pool.unused_len];
+    } else {
+        if(pool.handles_len == pool.handles_capacity) {
+            pool.handles_capacity = (pool.handles_capacity == 0 ? 16 : 2*pool.handles_capacity);
+            pool.handles = mem_realloc(pool.handles, pool.handles_capacity * sizeof(Task*));
+            pool.unused = mem_realloc(pool.unused, pool.handles_capacity * sizeof(int));
+        }
+        index = pool.handles_len++;
+    }
+    pool.handles[index] = task;
+    __atomic_fetch_add(&pool.pending, 1, __ATOMIC_RELAXED);
+    push(&pool.deques[(self >= 0) ? self : pool.next++ % pool.workers], task);
+    __atomic_fetch_add(&pool.queued, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+    return index + 1;
+}
+
+bool task_join(long handle, long* result) {
+    pthread_mutex_lock(&pool.lock);
+    Task* task = NULL;
+    if(handle >= 1 && handle <= pool.handles_len) {
+        task = pool.handles[handle - 1];
+    }
+    if(task != NULL) {
+        pool.handles[handle - 1] = NULL;
+        pool.unused[pool.unused_len++] = handle - 1;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    if(task == NULL) return false;
+
+    help(task);
+    *result = task->result;
+    free(task);
+    return true;
+}
+
+void task_wait_all(void) {
+    if(!pool.started) return;
+    help(NULL);
+}
+
+void task_shutdown(void) {
+    if(!pool.started) return;
+    help(NULL);
+    pthread_mutex_lock(&pool.lock);
+    pool.stopping = true;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+    for(int i = 0; i < pool.threads_len; i++) pthread_join(pool.threads[i], NULL);
+
+    for(int i = 0; i < pool.handles_len; i++) free(pool.handles[i]);
+    for(int i = 0; i < pool.workers; i++) {
+        pthread_mutex_destroy(&pool.deques[i].lock);
+        free(pool.deques[i].items);
+    }
+    free(pool.handles);
+    free(pool.unused);
+    free(pool.deques);
+    free(pool.threads);
+    pool.started = false;
+}
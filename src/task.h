@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include "eval.h"
+#include "parser.h"
+
+// Blocks started with .spawn run on a pool of one worker per core. Each
+// worker keeps its own deque of tasks, running the newest itself while
+// idle workers steal the oldest. A thread waiting in .join runs queued
+// tasks instead of blocking, so nested spawns cannot starve the pool.
+//
+// A task starts with a copy of its parent's variables as they were at
+// the .spawn, including $LAST and $ERRNO. From then on the two scopes
+// are independent: the task never sees later writes by its parent, and
+// its own writes are lost when it finishes, except for the block's
+// result, which .join returns.
+
+// How a task runs its block; set to the engine the interpreter uses.
+extern long (*task_runner)(Ast* ast, Block block, Vars* vars);
+
+// Queues block and returns a handle for task_join.
+long task_spawn(Ast* ast, Block block, Vars* parent);
+
+// Waits for a task and frees it. Returns false if handle does not name
+// a task that has not been joined yet.
+bool task_join(long handle, long* result);
+
+// Waits until every spawned task has finished, joined or not. Must be
+// called before the ast tasks were spawned from is reset or freed.
+void task_wait_all(void);
+
+// Stops the workers and frees every task that was never joined.
+void task_shutdown(void);
@@ -0,0 +1,114 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "names.h"
+#include "sys.h"
+#include "trace.h"
+
+// Latencies are bucketed by powers of two nanoseconds.
+#define BUCKETS 40
+
+typedef struct {
+    long calls;
+    long errors;
+    long ns;
+    long hist[BUCKETS];
+} TraceEntry;
+
+bool trace_enabled = false;
+
+static TraceEntry entries[SYSCALL_COUNT];
+
+long trace_clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+void trace_record(long id, long ns, bool failed) {
+    if(id < 0 || id >= SYSCALL_COUNT) return;
+    TraceEntry* e = &entries[id];
+    int bucket = (ns <= 0) ? 0 : 64 - __builtin_clzl(ns);
+    if(bucket >= BUCKETS) bucket = BUCKETS - 1;
+    // Tasks on other threads may be recording at the same time.
+    __atomic_fetch_add(&e->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->errors, failed, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->hist[bucket], 1, __ATOMIC_RELAXED);
+}
+
+long trace_call(long id, const long* args) {
+    long start = trace_clock();
+    long result = sys_direct(id, args);
+    long end = trace_clock();
+    trace_record(id, end - start, sys_error(result) != 0);
+    return result;
+}
+
+static int by_time(const void* a, const void* b) {
+    long ta = entries[*(const int*)a].ns;
+    long tb = entries[*(const int*)b].ns;
+    return (ta < tb) - (ta > tb);
+}
+
+static void print_bound(FILE* out, long ns) {
+    if(ns < 1000) fprintf(out, "%ldns", ns);
+    else if(ns < 1000000) fprintf(out, "%ldus", ns / 1000);
+    else if(ns < 1000000000) fprintf(out, "%ldms", ns / 1000000);
+    else fprintf(out, "%lds", ns / 1000000000);
+}
+
+void trace_summary(FILE* out) {
+    int order[SYSCALL_COUNT];
+    int used = 0;
+    long total_ns = 0;
+    long total_calls = 0;
+    long total_errors = 0;
+    for(int i = 0; i < SYSCALL_COUNT; i++) {
+        if(entries[i].calls == 0) continue;
+        order[used++] = i;
+        total_ns += entries[i].ns;
+        total_calls += entries[i].calls;
+        total_errors += entries[i].errors;
+    }
+    qsort(order, used, sizeof(int), by_time);
+
+    const char* rule = "------ ----------- ----------- --------- --------- ----------------\n";
+    fprintf(out, "%% time     seconds  usecs/call     calls    errors syscall\n");
+    fprintf(out, "%s", rule);
+    for(int i = 0; i < used; i++) {
+        TraceEntry* e = &entries[order[i]];
+        double pct = total_ns ? 100.0 * e->ns / total_ns : 0.0;
+        fprintf(out, "%6.2f %11.6f %11ld %9ld ", pct, e->ns / 1e9, e->ns / 1000 / e->calls, e->calls);
+        if(e->errors) fprintf(out, "%9ld ", e->errors);
+        else fprintf(out, "%9s ", "");
+        fprintf(out, "%s\n", syscall_names[order[i]] ? syscall_names[order[i]] : "?");
+    }
+    fprintf(out, "%s", rule);
+    fprintf(out, "100.00 %11.6f %11ld %9ld %9ld total\n",
+            total_ns / 1e9, total_calls ? total_ns / 1000 / total_calls : 0, total_calls, total_errors);
+
+    for(int i = 0; i < used; i++) {
+        TraceEntry* e = &entries[order[i]];
+        fprintf(out, "\n%s latency:\n", syscall_names[order[i]] ? syscall_names[order[i]] : "?");
+        long peak = 0;
+        for(int b = 0; b < BUCKETS; b++) {
+            if(e->hist[b] > peak) peak = e->hist[b];
+        }
+        for(int b = 0; b < BUCKETS; b++) {
+            if(e->hist[b] == 0) continue;
+            long lo = (b == 0) ? 0 : 1L << (b - 1);
+            fprintf(out, "  [");
+            print_bound(out, lo);
+            fprintf(out, ", ");
+            print_bound(out, 1L << b);
+            fprintf(out, ")\t%9ld |", e->hist[b]);
+            int bar = (int)(40 * e->hist[b] / peak);
+            for(int j = 0; j < bar; j++) fputc('#', out);
+            fputc('\n', out);
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Per-syscall counters for --trace-summary.
+extern bool trace_enabled;
+
+// Issues a syscall and records its latency and outcome. Returns -errno
+// on failure, like sys_direct.
+long trace_call(long id, const long* args);
+
+// Monotonic clock in nanoseconds.
+long trace_clock(void);
+
+// Records a call that was issued some other way, e.g. through io_uring.
+void trace_record(long id, long ns, bool failed);
+
+// Prints an strace -c style table followed by latency histograms.
+void trace_summary(FILE* out);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+
 #define C_ALLOC     -2
 #define C_REALLOC   -3
 #define C_FREE      -4
@@ -12,6 +14,32 @@
 #define C_SUB       -11
 #define C_MUL       -12
 #define C_DIV       -13
+#define C_BATCH     -14
+
+// Internal id with no name: a line the optimizer has folded to the
+// constant in its single ARG_NUM argument.
+#define C_VALUE     -15
 
+#define C_SPAWN     -16
+#define C_JOIN      -17
+#define C_FIND      -18
+#define C_COUNT     -19
+#define C_CMP       -20
+#define C_FILL      -21
+#define C_MEMSTAT   -22
+#define C_PUMP      -23
+#define C_STATS     -24
+#define C_PSPAWN    -25
+#define C_LOAD8     -26
+#define C_LOAD16    -27
+#define C_LOAD32    -28
+#define C_LOAD64    -29
+#define C_STORE8    -30
+#define C_STORE16   -31
+#define C_STORE32   -32
+#define C_STORE64   -33
+#define C_PACK      -34
+#define C_UNPACK    -35
 
-long trie_get(const char* key);
+// Looks up a command or syscall name given as a (pointer, length) slice.
+long trie_get(const char* key, size_t len);
@@ -0,0 +1,56 @@
+#include <elf.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/auxv.h>
+#include <sys/syscall.h>
+
+#include "vdso.h"
+
+VdsoFn vdso_table[SYSCALL_COUNT];
+
+static const struct {
+    const char* name;
+    long id;
+} entries[] = {
+    {"__vdso_clock_gettime", SYS_clock_gettime},
+    {"__vdso_gettimeofday",  SYS_gettimeofday},
+    {"__vdso_time",          SYS_time},
+    {"__vdso_getcpu",        SYS_getcpu},
+};
+
+// The vDSO is a complete shared object, section headers included, so
+// its dynamic symbols can be read straight out of the mapping.
+void vdso_init(void) {
+    const char* base = (const char*)getauxval(AT_SYSINFO_EHDR);
+    if(base == NULL) return;
+    const Elf64_Ehdr* ehdr = (const Elf64_Ehdr*)base;
+    if(memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 || ehdr->e_ident[EI_CLASS] != ELFCLASS64) return;
+
+    // Symbol values are link-time addresses; the first loadable segment
+    // says where the image was actually placed.
+    const Elf64_Phdr* phdrs = (const Elf64_Phdr*)(base + ehdr->e_phoff);
+    long load_offset = -1;
+    for(int i = 0; i < ehdr->e_phnum; i++) {
+        if(phdrs[i].p_type == PT_LOAD) {
+            load_offset = (long)base + phdrs[i].p_offset - phdrs[i].p_vaddr;
+            break;
+        }
+    }
+    if(load_offset == -1 || ehdr->e_shoff == 0) return;
+
+    const Elf64_Shdr* shdrs = (const Elf64_Shdr*)(base + ehdr->e_shoff);
+    for(int i = 0; i < ehdr->e_shnum; i++) {
+        if(shdrs[i].sh_type != SHT_DYNSYM || shdrs[i].sh_entsize == 0) continue;
+        const Elf64_Sym* syms = (const Elf64_Sym*)(base + shdrs[i].sh_offset);
+        const char* strs = base + shdrs[shdrs[i].sh_link].sh_offset;
+        size_t count = shdrs[i].sh_size / shdrs[i].sh_entsize;
+        for(size_t s = 0; s < count; s++) {
+            if(ELF64_ST_TYPE(syms[s].st_info) != STT_FUNC || syms[s].st_shndx == SHN_UNDEF) continue;
+            for(size_t e = 0; e < sizeof(entries) / sizeof(entries[0]); e++) {
+                if(strcmp(strs + syms[s].st_name, entries[e].name) == 0) {
+                    vdso_table[entries[e].id] = (VdsoFn)(load_offset + syms[s].st_value);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+#include <sys/syscall.h>
+
+#include "names.h"
+
+// Entry points the kernel exports through the vDSO, indexed by the
+// syscall they stand in for. Calling one costs a function call instead
+// of a kernel entry. Like the syscall instruction, they return -errno
+// on failure. Entries stay NULL until vdso_init finds them. They are
+// stored untyped and called through their real type, as only time
+// returns a long and the others an int.
+typedef void (*VdsoFn)(void);
+typedef long (*VdsoLongFn)(long, long, long);
+typedef int (*VdsoIntFn)(long, long, long);
+
+extern VdsoFn vdso_table[SYSCALL_COUNT];
+
+// Calls the entry for id, which must be set. An int result leaves the
+// upper half of rax unspecified, so it is sign-extended from 32 bits.
+static inline long vdso_call(long id, const long* args) {
+    if(id == SYS_time) return ((VdsoLongFn)vdso_table[id])(args[0], args[1], args[2]);
+    return ((VdsoIntFn)vdso_table[id])(args[0], args[1], args[2]);
+}
+
+// Looks up clock_gettime, gettimeofday, time and getcpu in the vDSO the
+// kernel mapped into this process.
+void vdso_init(void);
@@ -0,0 +1,387 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#include "buf.h"
+#include "coalesce.h"
+#include "compiler.h"
+#include "eval.h"
+#include "heap.h"
+#include "jit.h"
+#include "layout.h"
+#include "mem.h"
+#include "profile.h"
+#include "pspawn.h"
+#include "pump.h"
+#include "stats.h"
+#include "sys.h"
+#include "task.h"
+#include "vm.h"
+
+// The dispatch loop uses computed goto, which is a GNU extension.
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+static void report(const char* msg) {
+    coalesce_flush();
+    fprintf(stderr, "sysh: %s\n", msg);
+}
+
+long vm_run(Program* p, Vars* vars) {
+    static void* dispatch[OP_COUNT] = {
+        [OP_HALT]    = &&op_halt,
+        [OP_PUSH]    = &&op_push,
+        [OP_PUSHSTR] = &&op_pushstr,
+        [OP_CLONE]   = &&op_clone,
+        [OP_LOAD]    = &&op_load,
+        [OP_SET]     = &&op_set,
+        [OP_UNSET]   = &&op_unset,
+        [OP_POP]     = &&op_pop,
+        [OP_LAST]    = &&op_last,
+        [OP_SYSCALL] = &&op_syscall,
+        [OP_ALLOC]   = &&op_alloc,
+        [OP_REALLOC] = &&op_realloc,
+        [OP_FREE]    = &&op_free,
+        [OP_CPY]     = &&op_cpy,
+        [OP_DEREF]   = &&op_deref,
+        [OP_ADD]     = &&op_add,
+        [OP_SUB]     = &&op_sub,
+        [OP_MUL]     = &&op_mul,
+        [OP_DIV]     = &&op_div,
+        [OP_BATCH]   = &&op_batch,
+        [OP_SPAWN]   = &&op_spawn,
+        [OP_JOIN]    = &&op_join,
+        [OP_FINDBYTE] = &&op_findbyte,
+        [OP_FIND]    = &&op_find,
+        [OP_COUNTBYTE] = &&op_countbyte,
+        [OP_CMP]     = &&op_cmp,
+        [OP_FILL]    = &&op_fill,
+        [OP_MEMSTAT] = &&op_memstat,
+        [OP_PUMP]    = &&op_pump,
+        [OP_STATS]   = &&op_stats,
+        [OP_PSPAWN]  = &&op_pspawn,
+        [OP_PEEK8]   = &&op_peek8,
+        [OP_PEEK16]  = &&op_peek16,
+        [OP_PEEK32]  = &&op_peek32,
+        [OP_PEEK64]  = &&op_peek64,
+        [OP_POKE8]   = &&op_poke8,
+        [OP_POKE16]  = &&op_poke16,
+        [OP_POKE32]  = &&op_poke32,
+        [OP_POKE64]  = &&op_poke64,
+        [OP_PACK]    = &&op_pack,
+        [OP_UNPACK]  = &&op_unpack,
+        [OP_DEPTH]   = &&op_depth,
+        [OP_ENTER]   = &&op_enter,
+        [OP_LEAVE]   = &&op_leave,
+        [OP_JZ]      = &&op_jz,
+        [OP_JMP]     = &&op_jmp,
+        [OP_LOOP]    = &&op_loop,
+        [OP_ERROR]   = &&op_error,
+        [OP_FAIL]    = &&op_fail,
+    };
+    long* code = p->code;
+    long* stack = mem_alloc((p->max_depth + 1) * sizeof(long));
+    long* sp = stack;
+    long* ip = code;
+    long* values = vars->values;
+    bool* set = vars->set;
+
+#define NEXT goto *dispatch[*ip++]
+    NEXT;
+
+op_push:
+    *sp++ = *ip++;
+    NEXT;
+op_pushstr:
+    *sp++ = *ip++;
+    NEXT;
+op_clone:
+    sp[-1] = (long)heap_strdup((const char*)sp[-1]);
+    stats_bump(STAT_CLONES);
+    NEXT;
+op_load:
+    if(!set[ip[0]]) {
+        ip = code + ip[1];
+        NEXT;
+    }
+    *sp++ = values[ip[0]];
+    ip += 2;
+    NEXT;
+op_set:
+    values[*ip] = *--sp;
+    set[*ip++] = true;
+    NEXT;
+op_unset:
+    set[*ip++] = false;
+    NEXT;
+op_pop:
+    sp--;
+    NEXT;
+op_last:
+    stats_line(*ip++);
+    values[SLOT_LAST] = sp[-1];
+    set[SLOT_LAST] = true;
+    if(errno > 0) {
+        coalesce_flush();
+        fprintf(stderr, "sysh: E%d: %s\n", errno, strerror(errno));
+        errno = 0;
+    }
+    NEXT;
+op_syscall: {
+    long argc = ip[1];
+    long args[6] = {0,0,0,0,0,0};
+    sp -= argc;
+    for(int i = 0; i < argc; i++) {
+        args[i] = sp[i];
+    }
+    long result = sys_call(ip[0], args);
+    long err = sys_error(result);
+    values[SLOT_ERRNO] = err;
+    set[SLOT_ERRNO] = true;
+    if(err != 0) {
+        errno = err;
+        result = -1;
+    }
+    *sp++ = result;
+    ip += 2;
+    NEXT;
+}
+op_alloc:
+    sp[-1] = (long)heap_alloc(sp[-1]);
+    NEXT;
+op_realloc:
+    sp--;
+    sp[-1] = (long)heap_realloc((void*)sp[-1], sp[0]);
+    NEXT;
+op_free:
+    heap_free((void*)sp[-1]);
+    sp[-1] = 0;
+    NEXT;
+op_cpy:
+    sp -= 2;
+    memcpy((void*)sp[-1], (void*)sp[1], sp[0]);
+    sp[-1] = 0;
+    NEXT;
+op_deref:
+    sp[-1] = *((unsigned char*)sp[-1]);
+    NEXT;
+op_add:
+    sp--;
+    sp[-1] = sp[-1] + sp[0];
+    NEXT;
+op_sub:
+    sp--;
+    sp[-1] = sp[-1] - sp[0];
+    NEXT;
+op_mul:
+    sp--;
+    sp[-1] = sp[-1] * sp[0];
+    NEXT;
+op_div:
+    sp--;
+    sp[-1] = sp[-1] / sp[0];
+    NEXT;
+op_batch: {
+    long len = *ip++;
+    if(len == 0) {
+        *sp++ = batch_results(NULL, NULL, 0, vars);
+        NEXT;
+    }
+    BatchOp inline_ops[BATCH_INLINE];
+    int inline_slots[BATCH_INLINE];
+    BatchOp* ops = inline_ops;
+    int* slots = inline_slots;
+    if(len > BATCH_INLINE) {
+        ops = mem_alloc(len * sizeof(BatchOp));
+        slots = mem_alloc(len * sizeof(int));
+    }
+    long argc = 0;
+    for(int i = 0; i < len; i++) {
+        argc += ip[3*i + 1];
+    }
+    sp -= argc;
+    long* arg = sp;
+    for(int i = 0; i < len; i++) {
+        ops[i] = (BatchOp){.id = ip[0], .args = {0,0,0,0,0,0}};
+        for(int j = 0; j < ip[1]; j++) {
+            ops[i].args[j] = *arg++;
+        }
+        slots[i] = ip[2];
+        ip += 3;
+    }
+    batch_run(ops, len);
+    *sp++ = batch_results(ops, slots, len, vars);
+    if(ops != inline_ops) {
+        free(ops);
+        free(slots);
+    }
+    NEXT;
+}
+op_spawn:
+    *sp++ = task_spawn((Ast*)ip[0], (Block){.lines = ip[1], .len = ip[2]}, vars);
+    ip += 3;
+    NEXT;
+op_join:
+    if(!task_join(sp[-1], &sp[-1])) {
+        report("bad handle to .join");
+        sp[-1] = -1;
+    }
+    NEXT;
+op_findbyte:
+    sp -= 2;
+    sp[-1] = buf_find_byte((const void*)sp[-1], sp[0], sp[1]);
+    NEXT;
+op_find:
+    sp -= 3;
+    sp[-1] = buf_find((const void*)sp[-1], sp[0], (const void*)sp[1], sp[2]);
+    NEXT;
+op_countbyte:
+    sp -= 2;
+    sp[-1] = buf_count((const void*)sp[-1], sp[0], sp[1]);
+    NEXT;
+op_cmp:
+    sp -= 2;
+    sp[-1] = buf_cmp((const void*)sp[-1], (const void*)sp[0], sp[1]);
+    NEXT;
+op_fill:
+    sp -= 2;
+    sp[-1] = buf_fill((void*)sp[-1], sp[0], sp[1]);
+    NEXT;
+op_memstat:
+    sp[-1] = heap_stat(sp[-1]);
+    NEXT;
+op_stats:
+    sp[-1] = stats_get(sp[-1]);
+    NEXT;
+op_depth:
+    stats_depth(*ip++);
+    NEXT;
+op_enter:
+    shadow_enter(ip[1], (const Line*)ip[0]);
+    ip += 2;
+    NEXT;
+op_leave:
+    shadow_leave(*ip++);
+    NEXT;
+op_pump:
+    sp -= 2;
+    errno = 0;
+    sp[-1] = pump(sp[-1], sp[0], sp[1]);
+    values[SLOT_ERRNO] = errno;
+    set[SLOT_ERRNO] = true;
+    NEXT;
+op_pspawn:
+    sp -= 5;
+    errno = 0;
+    sp[-1] = pspawn((const char*)sp[-1], (const char*)sp[0], (const char*)sp[1], sp[2], sp[3], sp[4]);
+    values[SLOT_ERRNO] = errno;
+    set[SLOT_ERRNO] = true;
+    NEXT;
+op_peek8:
+    sp[-1] = layout_load((void*)sp[-1], 1);
+    NEXT;
+op_peek16:
+    sp[-1] = layout_load((void*)sp[-1], 2);
+    NEXT;
+op_peek32:
+    sp[-1] = layout_load((void*)sp[-1], 4);
+    NEXT;
+op_peek64:
+    sp[-1] = layout_load((void*)sp[-1], 8);
+    NEXT;
+op_poke8:
+    sp--;
+    layout_store((void*)sp[-1], 1, sp[0]);
+    sp[-1] = 0;
+    NEXT;
+op_poke16:
+    sp--;
+    layout_store((void*)sp[-1], 2, sp[0]);
+    sp[-1] = 0;
+    NEXT;
+op_poke32:
+    sp--;
+    layout_store((void*)sp[-1], 4, sp[0]);
+    sp[-1] = 0;
+    NEXT;
+op_poke64:
+    sp--;
+    layout_store((void*)sp[-1], 8, sp[0]);
+    sp[-1] = 0;
+    NEXT;
+op_pack: {
+    long n = *ip++;
+    sp -= n + 1;
+    sp[-1] = layout_pack((void*)sp[-1], (const char*)sp[0], sp + 1, n);
+    if(sp[-1] < 0) report("bad layout for .pack");
+    NEXT;
+}
+op_unpack: {
+    long n = *ip++;
+    long inline_fields[UNPACK_INLINE];
+    long* fields = inline_fields;
+    if(n > UNPACK_INLINE) fields = mem_alloc(n * sizeof(long));
+    sp--;
+    sp[-1] = layout_unpack((void*)sp[-1], (const char*)sp[0], fields, n);
+    if(sp[-1] < 0) {
+        report("bad layout for .unpack");
+    } else {
+        for(long i = 0; i < n; i++) {
+            values[ip[i]] = fields[i];
+            set[ip[i]] = true;
+        }
+    }
+    if(fields != inline_fields) free(fields);
+    ip += n;
+    NEXT;
+}
+op_jz:
+    if(*--sp == 0) {
+        ip = code + *ip;
+    } else {
+        ip++;
+    }
+    NEXT;
+op_jmp:
+    ip = code + *ip;
+    NEXT;
+op_loop: {
+    if(++ip[2] < JIT_THRESHOLD) {
+        ip += 5;
+        NEXT;
+    }
+    JitCode* jit = jit_get((Ast*)ip[0], (Line*)ip[1], vars->len, ip[4]);
+    if(jit == NULL) {
+        // Never retried: the count cannot climb back to the threshold.
+        ip[2] = LONG_MIN;
+        ip += 5;
+        NEXT;
+    }
+    if(!jit_run(jit, vars, &sp[-1])) {
+        ip[2] = 0;
+        ip += 5;
+        NEXT;
+    }
+    ip = code + ip[3];
+    NEXT;
+}
+op_error:
+    report(p->msgs[*ip++]);
+    *sp++ = -1;
+    NEXT;
+op_fail:
+    report(p->msgs[ip[0]]);
+    sp = stack + ip[1];
+    *sp++ = -1;
+    ip = code + ip[2];
+    NEXT;
+op_halt: {
+#undef NEXT
+    long result = sp > stack ? sp[-1] : 0;
+    free(stack);
+    return result;
+}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "compiler.h"
+#include "eval.h"
+
+long vm_run(Program* p, Vars* vars);